@@ -208,11 +208,11 @@ bool CompositeHash::RecoverOneVal(const HashKey& hk, Type* t, ValPtr* pval, bool
 			hk.Read("double", d);
 
 			if ( tag == TYPE_INTERVAL )
-				*pval = make_intrusive<IntervalVal>(d, 1.0);
+				*pval = val_mgr->Interval(d);
 			else if ( tag == TYPE_TIME )
 				*pval = make_intrusive<TimeVal>(d);
 			else
-				*pval = make_intrusive<DoubleVal>(d);
+				*pval = val_mgr->Double(d);
 			}
 			break;
 
@@ -12,6 +12,7 @@
 #include "zeek/NetVar.h"
 #include "zeek/Reporter.h"
 #include "zeek/RunState.h"
+#include "zeek/Stats.h"
 #include "zeek/Timer.h"
 #include "zeek/TunnelEncapsulation.h"
 #include "zeek/analyzer/Analyzer.h"
@@ -281,6 +282,87 @@ const RecordValPtr& Connection::GetVal()
 	return conn_val;
 	}
 
+// Schedules the removal of the analyzers below the given one that have a
+// tag in the set, or of all of them but the connection size analyzer if
+// the set is empty.
+static void disable_analyzers(analyzer::Analyzer* a, TableVal* tags)
+	{
+	for ( auto* child : a->GetChildren() )
+		{
+		if ( child->IsFinished() || child->Removing() )
+			continue;
+
+		if ( tags->Size() == 0 )
+			{
+			if ( ! child->IsAnalyzer("CONNSIZE") )
+				child->Remove();
+			}
+
+		else if ( tags->Find(child->GetAnalyzerTag().AsVal()) )
+			{
+			a->PreventChildren(child->GetAnalyzerTag());
+			child->Remove();
+			}
+
+		else
+			disable_analyzers(child, tags);
+		}
+	}
+
+void Connection::ChargeAnalysisBudget(int len, uint64_t start_ticks)
+	{
+	if ( analysis_budget_spent )
+		return;
+
+	analysis_bytes += len;
+
+	if ( start_ticks )
+		analysis_cpu_time += (zeek::detail::profile_ticks() - start_ticks) *
+		                     zeek::detail::profile_seconds_per_tick();
+
+	const char* budget = nullptr;
+
+	if ( BifConst::AnalysisBudget::max_bytes > 0 &&
+	     analysis_bytes > BifConst::AnalysisBudget::max_bytes )
+		budget = "bytes";
+
+	else if ( BifConst::AnalysisBudget::max_cpu_time > 0 &&
+	          analysis_cpu_time > BifConst::AnalysisBudget::max_cpu_time )
+		budget = "cpu_time";
+
+	if ( ! budget )
+		return;
+
+	analysis_budget_spent = true;
+
+	static auto actions = id::find_val<TableVal>("AnalysisBudget::actions");
+	static auto tags = id::find_val<TableVal>("AnalysisBudget::disable_analyzers");
+	static auto action_type = id::find_type<EnumType>("AnalysisBudget::Action");
+
+	auto have_action = [](const char* name)
+	{
+		auto action = action_type->GetEnumVal(action_type->Lookup("AnalysisBudget", name));
+		return actions->Find(action) != nullptr;
+	};
+
+	if ( adapter )
+		{
+		if ( have_action("DISABLE_ANALYZERS") )
+			disable_analyzers(adapter, tags.get());
+
+		if ( have_action("STOP_REASSEMBLY") )
+			adapter->StopReassembly();
+
+		if ( have_action("SKIP_CONTENT") )
+			adapter->SetSkip(true);
+		}
+
+	Weird("analysis_budget_exceeded", budget);
+
+	if ( analysis_budget_exceeded )
+		EnqueueEvent(analysis_budget_exceeded, nullptr, GetVal(), make_intrusive<StringVal>(budget));
+	}
+
 analyzer::Analyzer* Connection::FindAnalyzer(analyzer::ID id)
 	{
 	return adapter ? adapter->FindChild(id) : nullptr;
@@ -3,6 +3,7 @@
 #pragma once
 
 #include <sys/types.h>
+#include <map>
 #include <string>
 #include <tuple>
 #include <type_traits>
@@ -251,6 +252,17 @@ public:
 
 	bool PermitWeird(const char* name, uint64_t threshold, uint64_t rate, double duration);
 
+	// Accumulates the estimated CPU time the connection's analyzers
+	// spend, per analyzer type, when analyzer cost profiling is enabled.
+	void AddAnalyzerCPUTime(const zeek::Tag& tag, double t) { analyzer_cpu_time[tag] += t; }
+	const std::map<zeek::Tag, double>& AnalyzerCPUTime() const { return analyzer_cpu_time; }
+
+	// Accounts the analysis of a packet against the connection's analysis
+	// budget (see AnalysisBudget::max_bytes and max_cpu_time), taking the
+	// configured actions once it's exceeded.  The start is the value of
+	// profile_ticks() from before the analysis, or 0 if it wasn't timed.
+	void ChargeAnalysisBudget(int len, uint64_t start_ticks);
+
 private:
 	friend class session::detail::Timer;
 
@@ -265,6 +277,11 @@ private:
 	int suppress_event; // suppress certain events to once per conn.
 	RecordValPtr conn_val;
 	std::shared_ptr<EncapsulationStack> encapsulation; // tunnels
+	std::map<zeek::Tag, double> analyzer_cpu_time;
+
+	uint64_t analysis_bytes = 0;
+	double analysis_cpu_time = 0.0;
+	bool analysis_budget_spent = false;
 
 	detail::ConnKey key;
 
@@ -10,6 +10,7 @@
 #include "zeek/RunState.h"
 #include "zeek/Trigger.h"
 #include "zeek/Val.h"
+#include "zeek/ZVal.h"
 #include "zeek/iosource/Manager.h"
 #include "zeek/iosource/PktSrc.h"
 #include "zeek/plugin/Manager.h"
@@ -29,6 +30,38 @@ Event::Event(EventHandlerPtr arg_handler, zeek::Args arg_args, util::detail::Sou
 		Ref(obj);
 	}
 
+Event::Event(EventHandlerPtr arg_handler, const ZVal* arg_zargs, int nargs)
+	: handler(arg_handler), zargs(arg_zargs, arg_zargs + nargs), src(util::detail::SOURCE_LOCAL),
+	  aid(0), obj(nullptr), next_event(nullptr)
+	{
+	ztypes = &handler->GetType()->ParamList()->GetTypes();
+
+	for ( auto i = 0; i < nargs; ++i )
+		if ( ZVal::IsManagedType((*ztypes)[i]) )
+			Ref(zargs[i].ManagedVal());
+	}
+
+Event::~Event()
+	{
+	if ( ztypes )
+		for ( auto i = 0U; i < zargs.size(); ++i )
+			ZVal::DeleteIfManaged(zargs[i], (*ztypes)[i]);
+	}
+
+void Event::BoxArgs() const
+	{
+	args.reserve(zargs.size());
+
+	for ( auto i = 0U; i < zargs.size(); ++i )
+		{
+		args.emplace_back(zargs[i].ToVal((*ztypes)[i]));
+		ZVal::DeleteIfManaged(zargs[i], (*ztypes)[i]);
+		}
+
+	zargs.clear();
+	ztypes = nullptr;
+	}
+
 void Event::Describe(ODesc* d) const
 	{
 	if ( d->IsReadable() )
@@ -39,7 +72,7 @@ void Event::Describe(ODesc* d) const
 
 	if ( ! d->IsBinary() )
 		d->Add("(");
-	describe_vals(args, d);
+	describe_vals(Args(), d);
 	if ( ! d->IsBinary() )
 		d->Add("(");
 	}
@@ -54,7 +87,15 @@ void Event::Dispatch(bool no_remote)
 
 	try
 		{
-		handler->Call(&args, no_remote);
+		if ( ztypes && handler->CanCallWithZVals(no_remote) )
+			handler->CallWithZVals(zargs.data());
+		else
+			{
+			if ( ztypes )
+				BoxArgs();
+
+			handler->Call(&args, no_remote);
+			}
 		}
 
 	catch ( InterpreterException& e )
@@ -97,6 +138,11 @@ void EventMgr::Enqueue(const EventHandlerPtr& h, Args vl, util::detail::SourceID
 	QueueEvent(new Event(h, std::move(vl), src, aid, obj));
 	}
 
+void EventMgr::Enqueue(const EventHandlerPtr& h, const ZVal* zargs, int nargs)
+	{
+	QueueEvent(new Event(h, zargs, nargs));
+	}
+
 void EventMgr::QueueEvent(Event* event)
 	{
 	bool done = PLUGIN_HOOK_WITH_RESULT(HOOK_QUEUE_EVENT, HookQueueEvent(event), false);
@@ -4,6 +4,7 @@
 
 #include <tuple>
 #include <type_traits>
+#include <vector>
 
 #include "zeek/Flare.h"
 #include "zeek/IntrusivePtr.h"
@@ -16,6 +17,10 @@ namespace zeek
 	{
 
 class EventMgr;
+class Type;
+union ZVal;
+
+using TypePtr = IntrusivePtr<Type>;
 
 class Event final : public Obj
 	{
@@ -24,13 +29,25 @@ public:
 	      util::detail::SourceID src = util::detail::SOURCE_LOCAL, analyzer::ID aid = 0,
 	      Obj* obj = nullptr);
 
+	// An event whose arguments are given as ZVals, which have exactly
+	// the types of the handler's parameters.  The event holds its own
+	// references to them.
+	Event(EventHandlerPtr handler, const ZVal* zargs, int nargs);
+
+	~Event() override;
+
 	void SetNext(Event* n) { next_event = n; }
 	Event* NextEvent() const { return next_event; }
 
 	util::detail::SourceID Source() const { return src; }
 	analyzer::ID Analyzer() const { return aid; }
 	EventHandlerPtr Handler() const { return handler; }
-	const zeek::Args& Args() const { return args; }
+	const zeek::Args& Args() const
+		{
+		if ( ztypes )
+			BoxArgs();
+		return args;
+		}
 
 	void Describe(ODesc* d) const override;
 
@@ -41,8 +58,18 @@ protected:
 	// EventMgr::Dispatch().
 	void Dispatch(bool no_remote = false);
 
+	// Converts the ZVal arguments, if any, to Val's in "args".
+	void BoxArgs() const;
+
 	EventHandlerPtr handler;
-	zeek::Args args;
+	mutable zeek::Args args;
+
+	// For events raised by compiled scripts, the arguments as ZVals,
+	// along with their types.  "ztypes" is nil if there aren't any
+	// (anymore).
+	mutable std::vector<ZVal> zargs;
+	mutable const std::vector<TypePtr>* ztypes = nullptr;
+
 	util::detail::SourceID src;
 	analyzer::ID aid;
 	Obj* obj;
@@ -71,6 +98,19 @@ public:
 	             util::detail::SourceID src = util::detail::SOURCE_LOCAL, analyzer::ID aid = 0,
 	             Obj* obj = nullptr);
 
+	/**
+	 * A version of Enqueue() for compiled scripts, taking the arguments
+	 * as ZVals.  These need to have exactly the types of the handler's
+	 * parameters.  If the handler's bodies are compiled, too, dispatching
+	 * the event then passes the arguments to them without converting
+	 * them to Val's.
+	 * @param h  reference to the event handler to later call.
+	 * @param zargs  the arguments, which the event takes its own
+	 * references to.
+	 * @param nargs  the number of arguments.
+	 */
+	void Enqueue(const EventHandlerPtr& h, const ZVal* zargs, int nargs);
+
 	/**
 	 * A version of Enqueue() taking a variable number of arguments.
 	 */
@@ -65,21 +65,31 @@ void EventHandler::Call(Args* vl, bool no_remote)
 			{
 			// Send event in form [name, xs...] where xs represent the arguments.
 			broker::vector xs;
-			xs.reserve(vl->size());
 			bool valid_args = true;
+			std::optional<broker::vector> packed;
 
-			for ( auto i = 0u; i < vl->size(); ++i )
+			if ( broker_mgr->PackingEventArgs() )
+				packed = Broker::detail::pack_event_args(GetType(false)->ParamList(), *vl);
+
+			if ( packed )
+				xs = std::move(*packed);
+			else
 				{
-				auto opt_data = Broker::detail::val_to_data((*vl)[i].get());
+				xs.reserve(vl->size());
 
-				if ( opt_data )
-					xs.emplace_back(std::move(*opt_data));
-				else
+				for ( auto i = 0u; i < vl->size(); ++i )
 					{
-					valid_args = false;
-					auto_publish.clear();
-					reporter->Error("failed auto-remote event '%s', disabled", Name());
-					break;
+					auto opt_data = Broker::detail::val_to_data((*vl)[i].get());
+
+					if ( opt_data )
+						xs.emplace_back(std::move(*opt_data));
+					else
+						{
+						valid_args = false;
+						auto_publish.clear();
+						reporter->Error("failed auto-remote event '%s', disabled", Name());
+						break;
+						}
 					}
 				}
 
@@ -107,6 +117,26 @@ void EventHandler::Call(Args* vl, bool no_remote)
 		local->Invoke(vl);
 	}
 
+bool EventHandler::CanCallWithZVals(bool no_remote)
+	{
+	if ( ! local || local->GetKind() != Func::SCRIPT_FUNC )
+		return false;
+
+	if ( new_event || (! no_remote && ! auto_publish.empty()) )
+		return false;
+
+	return static_cast<detail::ScriptFunc*>(local.get())->CanInvokeWithZVals();
+	}
+
+void EventHandler::CallWithZVals(const ZVal* args)
+	{
+#ifdef PROFILE_BRO_FUNCTIONS
+	DEBUG_MSG("Event: %s\n", Name());
+#endif
+
+	static_cast<detail::ScriptFunc*>(local.get())->InvokeWithZVals(args);
+	}
+
 void EventHandler::NewEvent(Args* vl)
 	{
 	if ( ! new_event )
@@ -13,6 +13,7 @@ namespace zeek
 	{
 
 class Func;
+union ZVal;
 using FuncPtr = IntrusivePtr<Func>;
 
 class EventHandler
@@ -34,6 +35,16 @@ public:
 
 	void Call(zeek::Args* vl, bool no_remote = false);
 
+	// Returns true if the event can be delivered using CallWithZVals(),
+	// which requires the handler's bodies to all be compiled to ZAM and
+	// nothing to need the arguments as Val's, such as publishing the
+	// event remotely or raising new_event.
+	bool CanCallWithZVals(bool no_remote);
+
+	// Calls the handler with arguments given as ZVals having the types
+	// of its parameters.
+	void CallWithZVals(const ZVal* args);
+
 	// Returns true if there is at least one local or remote handler.
 	explicit operator bool() const;
 
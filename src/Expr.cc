@@ -20,6 +20,7 @@
 #include "zeek/Traverse.h"
 #include "zeek/Trigger.h"
 #include "zeek/Type.h"
+#include "zeek/ZVal.h"
 #include "zeek/broker/Data.h"
 #include "zeek/digest.h"
 #include "zeek/module_util.h"
@@ -265,6 +266,18 @@ bool Expr::InvertSense()
 	return false;
 	}
 
+bool Expr::EvalUnboxed(Frame* f, ZVal& v) const
+	{
+	auto val = Eval(f);
+	if ( ! val )
+		return false;
+
+	// For the types we're restricted to, this simply copies out the
+	// underlying value, without retaining a reference.
+	v = ZVal(std::move(val), type);
+	return true;
+	}
+
 void Expr::EvalIntoAggregate(const TypePtr& /* t */, ValPtr /* aggr */, Frame* /* f */) const
 	{
 	Internal("Expr::EvalIntoAggregate called");
@@ -746,6 +759,19 @@ ValPtr BinaryExpr::Eval(Frame* f) const
 	if ( IsError() )
 		return nullptr;
 
+	if ( ! unboxed_fold_init )
+		InitUnboxedFold();
+
+	if ( unboxed_fold )
+		{
+		// Only the final result needs boxing.
+		ZVal v;
+		if ( ! EvalUnboxed(f, v) )
+			return nullptr;
+
+		return v.ToVal(type);
+		}
+
 	auto v1 = op1->Eval(f);
 
 	if ( ! v1 )
@@ -807,6 +833,169 @@ ValPtr BinaryExpr::Eval(Frame* f) const
 	return Fold(v1.get(), v2.get());
 	}
 
+bool BinaryExpr::EvalUnboxed(Frame* f, ZVal& v) const
+	{
+	if ( IsError() )
+		return false;
+
+	if ( ! unboxed_fold_init )
+		InitUnboxedFold();
+
+	if ( ! unboxed_fold )
+		return Expr::EvalUnboxed(f, v);
+
+	ZVal v1, v2;
+	if ( ! op1->EvalUnboxed(f, v1) || ! op2->EvalUnboxed(f, v2) )
+		return false;
+
+	(*unboxed_fold)(this, v1, v2, v);
+	return true;
+	}
+
+// The type-specialized evaluators used by BinaryExpr::EvalUnboxed().
+// Their semantics need to match those of BinaryExpr::Fold().
+
+#define UNBOXED_FOLD(name, op, field, res_field)                                                   \
+	static void name(const BinaryExpr*, const ZVal& v1, const ZVal& v2, ZVal& res)                 \
+		{                                                                                          \
+		res.res_field = v1.field op v2.field;                                                      \
+		}
+
+#define UNBOXED_ARITH_FOLDS(name, op)                                                              \
+	UNBOXED_FOLD(name##_i, op, int_val, int_val)                                                   \
+	UNBOXED_FOLD(name##_u, op, uint_val, uint_val)                                                 \
+	UNBOXED_FOLD(name##_d, op, double_val, double_val)
+
+#define UNBOXED_CMP_FOLDS(name, op)                                                                \
+	UNBOXED_FOLD(name##_i, op, int_val, int_val)                                                   \
+	UNBOXED_FOLD(name##_u, op, uint_val, int_val)                                                  \
+	UNBOXED_FOLD(name##_d, op, double_val, int_val)
+
+#define UNBOXED_CHECKED_FOLD(name, op, field, msg)                                                 \
+	static void name(const BinaryExpr* e, const ZVal& v1, const ZVal& v2, ZVal& res)               \
+		{                                                                                          \
+		if ( v2.field == 0 )                                                                       \
+			reporter->ExprRuntimeError(e, "%s", msg);                                              \
+                                                                                                   \
+		res.field = v1.field op v2.field;                                                          \
+		}
+
+UNBOXED_ARITH_FOLDS(unboxed_add, +)
+UNBOXED_ARITH_FOLDS(unboxed_sub, -)
+UNBOXED_ARITH_FOLDS(unboxed_times, *)
+
+UNBOXED_CHECKED_FOLD(unboxed_divide_i, /, int_val, "division by zero")
+UNBOXED_CHECKED_FOLD(unboxed_divide_u, /, uint_val, "division by zero")
+UNBOXED_CHECKED_FOLD(unboxed_divide_d, /, double_val, "division by zero")
+UNBOXED_CHECKED_FOLD(unboxed_mod_i, %, int_val, "modulo by zero")
+UNBOXED_CHECKED_FOLD(unboxed_mod_u, %, uint_val, "modulo by zero")
+
+UNBOXED_FOLD(unboxed_and_u, &, uint_val, uint_val)
+UNBOXED_FOLD(unboxed_or_u, |, uint_val, uint_val)
+UNBOXED_FOLD(unboxed_xor_u, ^, uint_val, uint_val)
+
+UNBOXED_CMP_FOLDS(unboxed_lt, <)
+UNBOXED_CMP_FOLDS(unboxed_le, <=)
+UNBOXED_CMP_FOLDS(unboxed_eq, ==)
+UNBOXED_CMP_FOLDS(unboxed_ne, !=)
+UNBOXED_CMP_FOLDS(unboxed_ge, >=)
+UNBOXED_CMP_FOLDS(unboxed_gt, >)
+
+void BinaryExpr::InitUnboxedFold() const
+	{
+	unboxed_fold_init = true;
+	unboxed_fold = nullptr;
+
+	if ( IsError() )
+		return;
+
+	auto it = op1->GetType()->InternalType();
+
+	if ( it != TYPE_INTERNAL_INT && it != TYPE_INTERNAL_UNSIGNED && it != TYPE_INTERNAL_DOUBLE )
+		return;
+
+	if ( op2->GetType()->InternalType() != it )
+		return;
+
+	bool is_int = it == TYPE_INTERNAL_INT;
+	bool is_uint = it == TYPE_INTERNAL_UNSIGNED;
+
+	// Picks the evaluator for the operands' internal type.
+#define UNBOXED_BY_TYPE(name) (is_int ? name##_i : (is_uint ? name##_u : name##_d))
+
+	UnboxedFold arith = nullptr;
+	UnboxedFold cmp = nullptr;
+
+	switch ( tag )
+		{
+		case EXPR_ADD:
+			arith = UNBOXED_BY_TYPE(unboxed_add);
+			break;
+		case EXPR_SUB:
+			arith = UNBOXED_BY_TYPE(unboxed_sub);
+			break;
+		case EXPR_TIMES:
+			arith = UNBOXED_BY_TYPE(unboxed_times);
+			break;
+		case EXPR_DIVIDE:
+			arith = UNBOXED_BY_TYPE(unboxed_divide);
+			break;
+
+		case EXPR_MOD:
+			if ( is_int )
+				arith = unboxed_mod_i;
+			else if ( is_uint )
+				arith = unboxed_mod_u;
+			break;
+
+		case EXPR_AND:
+			if ( is_uint )
+				arith = unboxed_and_u;
+			break;
+		case EXPR_OR:
+			if ( is_uint )
+				arith = unboxed_or_u;
+			break;
+		case EXPR_XOR:
+			if ( is_uint )
+				arith = unboxed_xor_u;
+			break;
+
+		case EXPR_LT:
+			cmp = UNBOXED_BY_TYPE(unboxed_lt);
+			break;
+		case EXPR_LE:
+			cmp = UNBOXED_BY_TYPE(unboxed_le);
+			break;
+		case EXPR_EQ:
+			cmp = UNBOXED_BY_TYPE(unboxed_eq);
+			break;
+		case EXPR_NE:
+			cmp = UNBOXED_BY_TYPE(unboxed_ne);
+			break;
+		case EXPR_GE:
+			cmp = UNBOXED_BY_TYPE(unboxed_ge);
+			break;
+		case EXPR_GT:
+			cmp = UNBOXED_BY_TYPE(unboxed_gt);
+			break;
+
+		default:
+			// Includes operations whose subclasses override Eval(),
+			// such as "&&", "+=" and assignments.
+			break;
+		}
+
+#undef UNBOXED_BY_TYPE
+
+	// The result representation needs to match what Fold() produces.
+	if ( arith && type->InternalType() == it )
+		unboxed_fold = arith;
+
+	else if ( cmp && type->Tag() == TYPE_BOOL )
+		unboxed_fold = cmp;
+	}
+
 bool BinaryExpr::IsPure() const
 	{
 	return op1->IsPure() && op2->IsPure();
@@ -1020,11 +1209,11 @@ ValPtr BinaryExpr::Fold(Val* v1, Val* v2) const
 	const auto& ret_type = IsVector(GetType()->Tag()) ? GetType()->Yield() : GetType();
 
 	if ( ret_type->Tag() == TYPE_INTERVAL )
-		return make_intrusive<IntervalVal>(d3);
+		return val_mgr->Interval(d3);
 	else if ( ret_type->Tag() == TYPE_TIME )
 		return make_intrusive<TimeVal>(d3);
 	else if ( ret_type->Tag() == TYPE_DOUBLE )
-		return make_intrusive<DoubleVal>(d3);
+		return val_mgr->Double(d3);
 	else if ( ret_type->InternalType() == TYPE_INTERNAL_UNSIGNED )
 		return val_mgr->Count(u3);
 	else if ( ret_type->Tag() == TYPE_BOOL )
@@ -1206,6 +1395,7 @@ void BinaryExpr::SwapOps()
 	// We could check here whether the operator is commutative.
 	using std::swap;
 	swap(op1, op2);
+	ResetUnboxedFold();
 	}
 
 void BinaryExpr::PromoteOps(TypeTag t)
@@ -1471,9 +1661,9 @@ NegExpr::NegExpr(ExprPtr arg_op) : UnaryExpr(EXPR_NEGATE, std::move(arg_op))
 ValPtr NegExpr::Fold(Val* v) const
 	{
 	if ( v->GetType()->Tag() == TYPE_DOUBLE )
-		return make_intrusive<DoubleVal>(-v->InternalDouble());
+		return val_mgr->Double(-v->InternalDouble());
 	else if ( v->GetType()->Tag() == TYPE_INTERVAL )
-		return make_intrusive<IntervalVal>(-v->InternalDouble());
+		return val_mgr->Interval(-v->InternalDouble());
 	else
 		return val_mgr->Int(-v->CoerceToInt());
 	}
@@ -2154,6 +2344,7 @@ ValPtr EqExpr::Fold(Val* v1, Val* v2) const
 bool EqExpr::InvertSense()
 	{
 	tag = (tag == EXPR_EQ ? EXPR_NE : EXPR_EQ);
+	ResetUnboxedFold();
 	return true;
 	}
 
@@ -2217,6 +2408,8 @@ void RelExpr::Canonicize()
 
 bool RelExpr::InvertSense()
 	{
+	ResetUnboxedFold();
+
 	switch ( tag )
 		{
 		case EXPR_LT:
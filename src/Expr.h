@@ -21,6 +21,7 @@
 namespace zeek
 	{
 template <class T> class IntrusivePtr;
+union ZVal;
 
 namespace detail
 	{
@@ -164,6 +165,12 @@ public:
 	// or nil if the expression's value isn't fixed.
 	virtual ValPtr Eval(Frame* f) const = 0;
 
+	// Same, but for expressions whose type is represented internally
+	// as an integer, unsigned or double, and returning the value in
+	// unboxed form rather than as a Val.  Returns false under the same
+	// circumstances as Eval() returns nil.
+	virtual bool EvalUnboxed(Frame* f, ZVal& v) const;
+
 	// Same, but the context is that we are adding an element
 	// into the given aggregate of the given type.  Note that
 	// return type is void since it's updating an existing
@@ -560,6 +567,7 @@ public:
 	// class that overrides Eval() should be modified to handle
 	// vectors correctly as necessary.
 	ValPtr Eval(Frame* f) const override;
+	bool EvalUnboxed(Frame* f, ZVal& v) const override;
 
 	TraversalCode Traverse(TraversalCallback* cb) const override;
 
@@ -574,8 +582,20 @@ public:
 	ExprPtr GetOp1() const override final { return op1; }
 	ExprPtr GetOp2() const override final { return op2; }
 
-	void SetOp1(ExprPtr _op) override final { op1 = std::move(_op); }
-	void SetOp2(ExprPtr _op) override final { op2 = std::move(_op); }
+	void SetOp1(ExprPtr _op) override final
+		{
+		op1 = std::move(_op);
+		ResetUnboxedFold();
+		}
+	void SetOp2(ExprPtr _op) override final
+		{
+		op2 = std::move(_op);
+		ResetUnboxedFold();
+		}
+
+	// Type-specialized evaluator for a scalar operation on unboxed
+	// operands.  Expects a run-time error to be thrown if it fails.
+	using UnboxedFold = void (*)(const BinaryExpr* e, const ZVal& v1, const ZVal& v2, ZVal& res);
 
 protected:
 	BinaryExpr(BroExprTag arg_tag, ExprPtr arg_op1, ExprPtr arg_op2)
@@ -603,6 +623,20 @@ protected:
 	virtual ValPtr AddrFold(Val* v1, Val* v2) const;
 	virtual ValPtr SubNetFold(Val* v1, Val* v2) const;
 
+	// Selects the type-specialized evaluator to use in lieu of Fold(),
+	// if any, upon first execution.  Only arithmetic, bitwise and
+	// comparison operations on integers, counts (including ports),
+	// doubles, times and intervals qualify.
+	void InitUnboxedFold() const;
+
+	// Needed if the operands or the operation change, which the
+	// optimizer can do even after the expression was executed.
+	void ResetUnboxedFold()
+		{
+		unboxed_fold = nullptr;
+		unboxed_fold_init = false;
+		}
+
 	bool BothConst() const { return op1->IsConst() && op2->IsConst(); }
 
 	// Exchange op1 and op2.
@@ -632,6 +666,9 @@ protected:
 
 	ExprPtr op1;
 	ExprPtr op2;
+
+	mutable UnboxedFold unboxed_fold = nullptr;
+	mutable bool unboxed_fold_init = false;
 	};
 
 class CloneExpr final : public UnaryExpr
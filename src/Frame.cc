@@ -168,6 +168,28 @@ void Frame::Reset(int startIdx)
 		ClearElement(i);
 	}
 
+bool Frame::Recycle()
+	{
+	if ( functions_with_closure_frame_reference || closure || offset_map || delayed ||
+	     outer_ids.length() > 0 )
+		return false;
+
+	for ( int i = 0; i < size; ++i )
+		ClearElement(i);
+
+	func_args = nullptr;
+	next_stmt = nullptr;
+	break_before_next_stmt = false;
+	break_on_return = false;
+	current_offset = 0;
+
+	trigger = nullptr;
+	call = nullptr;
+	call_loc = nullptr;
+
+	return true;
+	}
+
 void Frame::Describe(ODesc* d) const
 	{
 	if ( ! d->IsBinary() )
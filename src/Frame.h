@@ -114,6 +114,17 @@ public:
 	 */
 	void Reset(int startIdx);
 
+	/**
+	 * Readies a frame whose function call has completed for use by
+	 * another call to the same function, by clearing its values and
+	 * per-call state.  Only possible if nothing else can refer to the
+	 * frame, so the caller must hold its only reference.
+	 *
+	 * @return true if the frame can be reused, false if it has state
+	 * (a closure, or lambdas referring to it) that rules that out.
+	 */
+	bool Recycle();
+
 	/**
 	 * Describes the frame and all of its values.
 	 */
@@ -130,6 +141,14 @@ public:
 	 */
 	const Args* GetFuncArgs() const { return func_args; }
 
+	/**
+	 * Sets the arguments of the function call that the frame is
+	 * used for.  Needed when reusing a recycled frame.
+	 *
+	 * @param fn_args the arguments passed to the function.
+	 */
+	void SetFuncArgs(const zeek::Args* fn_args) { func_args = fn_args; }
+
 	/**
 	 * Change the function that the frame is associated with.
 	 *
@@ -49,6 +49,9 @@
 #include "zeek/iosource/PktSrc.h"
 #include "zeek/module_util.h"
 #include "zeek/plugin/Manager.h"
+#include "zeek/script_opt/DirectBiFs.h"
+#include "zeek/script_opt/ProfileFunc.h"
+#include "zeek/script_opt/ZAM/ZBody.h"
 #include "zeek/session/Manager.h"
 
 // Ignore clang-format's reordering of include files here so that it doesn't
@@ -344,6 +347,8 @@ ScriptFunc::ScriptFunc(std::string _name, FuncTypePtr ft, std::vector<StmtPtr> b
 
 ScriptFunc::~ScriptFunc()
 	{
+	ClearFramePool();
+
 	if ( ! weak_closure_ref )
 		Unref(closure);
 
@@ -385,7 +390,7 @@ ValPtr ScriptFunc::Invoke(zeek::Args* args, Frame* parent) const
 		return Flavor() == FUNC_FLAVOR_HOOK ? val_mgr->True() : nullptr;
 		}
 
-	auto f = make_intrusive<Frame>(frame_size, this, args);
+	auto f = NewFrame(args);
 
 	if ( closure )
 		f->CaptureClosure(closure, outer_ids);
@@ -498,10 +503,119 @@ ValPtr ScriptFunc::Invoke(zeek::Args* args, Frame* parent) const
 		}
 
 	g_frame_stack.pop_back();
+	ReleaseFrame(std::move(f));
 
 	return result;
 	}
 
+bool ScriptFunc::CanInvokeWithZVals() const
+	{
+	if ( bodies.empty() || closure || sample_logger || g_trace_state.DoTrace() || g_policy_debug )
+		return false;
+
+	if ( plugin_mgr->HavePluginForHook(plugin::HOOK_CALL_FUNCTION) )
+		return false;
+
+	for ( const auto& body : bodies )
+		if ( body.stmts->Tag() != STMT_ZAM ||
+		     ! static_cast<ZBody*>(body.stmts.get())->AcceptsZValArgs() )
+			return false;
+
+	return true;
+	}
+
+void ScriptFunc::InvokeWithZVals(const ZVal* args) const
+	{
+	SegmentProfiler prof(segment_logger, location);
+
+	// The frame is still needed for calls made by the bodies, and as
+	// the context for run-time errors.
+	static const zeek::Args no_args;
+	auto f = NewFrame(&no_args);
+
+	g_frame_stack.push_back(f.get()); // used for backtracing
+	call_stack.emplace_back(CallInfo{nullptr, this, no_args});
+
+	for ( const auto& body : bodies )
+		{
+		StmtFlowType flow = FLOW_NEXT;
+
+		try
+			{
+			static_cast<ZBody*>(body.stmts.get())->ExecWithArgs(f.get(), args, flow);
+			}
+
+		catch ( InterpreterException& e )
+			{
+			// Already reported, continue with the remaining bodies.
+			continue;
+			}
+		}
+
+	call_stack.pop_back();
+	g_frame_stack.pop_back();
+	ReleaseFrame(std::move(f));
+	}
+
+FramePtr ScriptFunc::NewFrame(const zeek::Args* args) const
+	{
+	if ( frame_pool.empty() )
+		return make_intrusive<Frame>(frame_size, this, args);
+
+	FramePtr f{AdoptRef{}, frame_pool.back()};
+	frame_pool.pop_back();
+	f->SetFuncArgs(args);
+
+	return f;
+	}
+
+void ScriptFunc::ReleaseFrame(FramePtr f) const
+	{
+	// Enough to cover modest recursion without holding on to much
+	// memory for functions that recurse deeply.
+	static constexpr size_t max_pooled_frames = 8;
+
+	// A reference count other than ours means something still refers
+	// to the frame, so it's in fact outliving the call.
+	if ( f->RefCnt() != 1 || frame_pool.size() >= max_pooled_frames || ! FramesReusable() ||
+	     ! f->Recycle() )
+		return;
+
+	frame_pool.push_back(f.release());
+	}
+
+bool ScriptFunc::FramesReusable() const
+	{
+	if ( frames_reusable >= 0 )
+		return frames_reusable;
+
+	frames_reusable = ! closure && ! type->GetCaptures();
+
+	for ( const auto& body : bodies )
+		{
+		if ( ! frames_reusable )
+			break;
+
+		// Compiled bodies don't expose their ASTs, but for those the
+		// run-time checks in ReleaseFrame() and Frame::Recycle()
+		// still catch frames that are being held on to.
+		ProfileFunc pf(body.stmts.get());
+		if ( pf.NumLambdas() > 0 || pf.NumWhenStmts() > 0 )
+			frames_reusable = 0;
+		}
+
+	return frames_reusable;
+	}
+
+void ScriptFunc::ClearFramePool()
+	{
+	for ( auto f : frame_pool )
+		Unref(f);
+
+	frame_pool.clear();
+	frames_reusable = -1;
+	}
+
 void ScriptFunc::CreateCaptures(Frame* f)
 	{
 	const auto& captures = type->GetCaptures();
@@ -564,6 +678,7 @@ void ScriptFunc::AddBody(StmtPtr new_body, const std::vector<IDPtr>& new_inits,
 		frame_size = num_args;
 
 	new_body = AddInits(std::move(new_body), new_inits);
+	ClearFramePool();
 
 	if ( Flavor() == FUNC_FLAVOR_FUNCTION )
 		{
@@ -585,6 +700,8 @@ void ScriptFunc::ReplaceBody(const StmtPtr& old_body, StmtPtr new_body)
 	{
 	bool found_it = false;
 
+	ClearFramePool();
+
 	for ( auto body = bodies.begin(); body != bodies.end(); ++body )
 		if ( body->stmts.get() == old_body.get() )
 			{
@@ -744,6 +861,7 @@ BuiltinFunc::BuiltinFunc(built_in_func arg_func, const char* arg_name, bool arg_
 	{
 	func = arg_func;
 	name = make_full_var_name(GLOBAL_MODULE_NAME, arg_name);
+	direct_func = find_direct_BiF(Name());
 	is_pure = arg_is_pure;
 
 	const auto& id = lookup_ID(Name(), GLOBAL_MODULE_NAME, false);
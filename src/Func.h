@@ -39,6 +39,7 @@ class Stmt;
 class CallExpr;
 class ID;
 class Frame;
+using FramePtr = IntrusivePtr<Frame>;
 using ScopePtr = IntrusivePtr<Scope>;
 using IDPtr = IntrusivePtr<ID>;
 using StmtPtr = IntrusivePtr<Stmt>;
@@ -164,6 +165,24 @@ public:
 	bool IsPure() const override;
 	ValPtr Invoke(zeek::Args* args, Frame* parent) const override;
 
+	/**
+	 * Returns true if the function's bodies can be executed with
+	 * arguments given as ZVals, using InvokeWithZVals().  That requires
+	 * them all to be compiled to ZAM, and nothing to need the arguments
+	 * as Val's, such as plugins hooking function calls or tracing.
+	 */
+	bool CanInvokeWithZVals() const;
+
+	/**
+	 * Executes the bodies of an event handler with the given arguments,
+	 * which have the types of the function's parameters.  Unlike
+	 * Invoke(), this doesn't store the arguments in the interpreter
+	 * frame, so they don't show up in backtraces.
+	 *
+	 * @param args  the arguments to the event.
+	 */
+	void InvokeWithZVals(const ZVal* args) const;
+
 	/**
 	 * Creates a separate frame for captures and initializes its
 	 * elements.  The list of captures comes from the ScriptFunc's
@@ -264,7 +283,11 @@ public:
 	 *
 	 * @param new_size  The frame size the function should use.
 	 */
-	void SetFrameSize(int new_size) { frame_size = new_size; }
+	void SetFrameSize(int new_size)
+		{
+		frame_size = new_size;
+		ClearFramePool();
+		}
 
 	/** Sets this function's outer_id list. */
 	void SetOuterIDs(IDPList ids) { outer_ids = std::move(ids); }
@@ -298,8 +321,33 @@ protected:
 	virtual void SetCaptures(Frame* f);
 
 private:
+	// Returns a frame for a call to the function, reusing one from
+	// an earlier call if available.
+	FramePtr NewFrame(const zeek::Args* args) const;
+
+	// Returns the frame of a completed call to the pool of frames for
+	// reuse, if it's safe to do so; otherwise it's simply released.
+	void ReleaseFrame(FramePtr f) const;
+
+	// Whether the function's frames can be reused across calls.  This
+	// requires that they can't outlive a call, so the function can't
+	// have a closure or captures, nor (per its profile) lambdas or
+	// "when" statements that might hold on to the frame.
+	bool FramesReusable() const;
+
+	// Discards any pooled frames, along with the FramesReusable()
+	// analysis, for when the bodies or the frame size change.
+	void ClearFramePool();
+
 	size_t frame_size = 0;
 
+	// Frames of completed calls, ready for reuse by subsequent ones.
+	mutable std::vector<Frame*> frame_pool;
+
+	// Whether FramesReusable(); computed when first needed, with -1
+	// meaning "not yet known".
+	mutable int frames_reusable = -1;
+
 	// List of the outer IDs used in the function.
 	IDPList outer_ids;
 
@@ -325,6 +373,10 @@ private:
 
 using built_in_func = BifReturnVal (*)(Frame* frame, const Args* args);
 
+// A version of a BiF that takes its arguments as ZVals, for direct calls
+// from compiled scripts.  See script_opt/DirectBiFs.h.
+using direct_built_in_func = ZVal (*)(const ZVal* args, const TypePtr* arg_types, int nargs);
+
 class BuiltinFunc final : public Func
 	{
 public:
@@ -335,16 +387,22 @@ public:
 	ValPtr Invoke(zeek::Args* args, Frame* parent) const override;
 	built_in_func TheFunc() const { return func; }
 
+	// Returns the version of the BiF taking ZVal arguments, or nil
+	// if there isn't one.
+	direct_built_in_func TheDirectFunc() const { return direct_func; }
+
 	void Describe(ODesc* d) const override;
 
 protected:
 	BuiltinFunc()
 		{
 		func = nullptr;
+		direct_func = nullptr;
 		is_pure = 0;
 		}
 
 	built_in_func func;
+	direct_built_in_func direct_func;
 	bool is_pure;
 	};
 
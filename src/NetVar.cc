@@ -112,6 +112,7 @@ namespace zeek::detail
 int watchdog_interval;
 
 int max_timer_expires;
+int max_deferred_deletes;
 
 int ignore_checksums;
 int partial_connection_ok;
@@ -173,6 +174,8 @@ int expensive_profiling_multiple;
 int segment_profiling;
 int pkt_profile_mode;
 double pkt_profile_freq;
+int packet_stage_sample_rate;
+int analyzer_cost_sample_rate;
 
 int load_sample_freq;
 
@@ -299,6 +302,7 @@ void init_net_var()
 	watchdog_interval = int(id::find_val("watchdog_interval")->AsInterval());
 
 	max_timer_expires = id::find_val("max_timer_expires")->AsCount();
+	max_deferred_deletes = id::find_val("max_deferred_deletes")->AsCount();
 
 	mime_segment_length = id::find_val("mime_segment_length")->AsCount();
 	mime_segment_overlap_length = id::find_val("mime_segment_overlap_length")->AsCount();
@@ -334,6 +338,8 @@ void init_net_var()
 
 	pkt_profile_mode = id::find_val("pkt_profile_mode")->InternalInt();
 	pkt_profile_freq = id::find_val("pkt_profile_freq")->AsDouble();
+	packet_stage_sample_rate = id::find_val("packet_stage_sample_rate")->AsCount();
+	analyzer_cost_sample_rate = id::find_val("analyzer_cost_sample_rate")->AsCount();
 
 	load_sample_freq = id::find_val("load_sample_freq")->AsCount();
 
@@ -12,6 +12,7 @@ namespace zeek::detail
 extern int watchdog_interval;
 
 extern int max_timer_expires;
+extern int max_deferred_deletes;
 
 extern int ignore_checksums;
 extern int partial_connection_ok;
@@ -75,6 +76,8 @@ extern int expensive_profiling_multiple;
 extern int segment_profiling;
 extern int pkt_profile_mode;
 extern double pkt_profile_freq;
+extern int packet_stage_sample_rate;
+extern int analyzer_cost_sample_rate;
 extern int load_sample_freq;
 
 extern int packet_filter_default;
@@ -5,6 +5,7 @@
 #include "zeek/zeek-config.h"
 
 #include <stdlib.h>
+#include <vector>
 
 #include "zeek/Desc.h"
 #include "zeek/File.h"
@@ -215,4 +216,38 @@ void obj_delete_func(void* v)
 	Unref((Obj*)v);
 	}
 
+namespace detail
+	{
+
+bool deferring_deletes = false;
+
+// Used as a stack, so that objects queued by deleting another one get
+// deleted next, while they're likely still in the cache.
+static std::vector<Obj*> deferred_deletes;
+
+void defer_delete(Obj* o)
+	{
+	deferred_deletes.push_back(o);
+	}
+
+size_t drain_deferred_deletes(size_t max_deletes)
+	{
+	// How many batches' worth we let queue up before catching up.
+	constexpr size_t max_backlog_batches = 100;
+
+	if ( max_deletes > 0 && deferred_deletes.size() > max_deletes * max_backlog_batches )
+		max_deletes = deferred_deletes.size() - max_deletes * (max_backlog_batches - 1);
+
+	for ( size_t n = 0; ! deferred_deletes.empty() && (max_deletes == 0 || n < max_deletes); ++n )
+		{
+		auto o = deferred_deletes.back();
+		deferred_deletes.pop_back();
+		delete o;
+		}
+
+	return deferred_deletes.size();
+	}
+
+	} // namespace detail
+
 	} // namespace zeek
@@ -5,6 +5,7 @@
 #include "zeek/zeek-config.h"
 
 #include <limits.h>
+#include <cstddef>
 
 namespace zeek
 	{
@@ -144,6 +145,10 @@ public:
 	void Print() const;
 
 protected:
+	// Marks the object as one whose deletion can be deferred; see
+	// detail::deferring_deletes.
+	void AllowDeferredDelete() { deferrable_delete = true; }
+
 	detail::Location* location; // all that matters in real estate
 
 private:
@@ -158,6 +163,7 @@ private:
 
 	int ref_cnt = 1;
 	bool notify_plugins = false;
+	bool deferrable_delete = false;
 
 	// If non-zero, do not print runtime errors.  Useful for
 	// speculative evaluation.
@@ -173,6 +179,29 @@ inline void Error(const Obj* o, const char* msg)
 
 [[noreturn]] extern void bad_ref(int type);
 
+namespace detail
+	{
+
+// If true, Unref() doesn't delete objects that allow for it, but queues
+// them for later deletion via drain_deferred_deletes().  This keeps
+// the destruction of large structures (say, a connection's record with
+// all of its tables) out of latency-sensitive processing.  Only values
+// allow for deferral, as other objects may have owners that rely on
+// their prompt destruction.
+extern bool deferring_deletes;
+
+extern void defer_delete(Obj* o);
+
+// Deletes up to the given number of queued objects, or all of them if
+// zero.  Objects that only the deleted ones referred to get queued in
+// turn, so a large structure is deleted over several calls.  If the
+// queue has fallen far behind, deletes more than the given number to
+// keep it from growing without bound.  Returns the number of objects
+// still queued.
+extern size_t drain_deferred_deletes(size_t max_deletes);
+
+	} // namespace detail
+
 inline void Ref(Obj* o)
 	{
 	if ( ++(o->ref_cnt) <= 1 )
@@ -187,7 +216,11 @@ inline void Unref(Obj* o)
 		{
 		if ( o->ref_cnt < 0 )
 			bad_ref(2);
-		delete o;
+
+		if ( o->deferrable_delete && detail::deferring_deletes )
+			detail::defer_delete(o);
+		else
+			delete o;
 
 		// We could do the following if o were passed by reference.
 		// o = (Obj*) 0xcd;
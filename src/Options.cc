@@ -189,6 +189,7 @@ static void print_analysis_help()
 	fprintf(stderr, "    dump-ZAM	dump generated ZAM code; implies gen-ZAM-code\n");
 	fprintf(stderr,
 	        "    gen-ZAM-code	generate ZAM code (without turning on additional optimizations)\n");
+	fprintf(stderr, "    fuse-events	combine each event's handler bodies into one; implies inline\n");
 	fprintf(stderr, "    inline	inline function calls\n");
 	fprintf(stderr, "    no-ZAM-opt	omit low-level ZAM optimization\n");
 	fprintf(stderr, "    optimize-all	optimize all scripts, even inlined ones\n");
@@ -201,6 +202,7 @@ static void print_analysis_help()
 	fprintf(stderr, "\n--optimize options when generating C++:\n");
 	fprintf(stderr, "    add-C++	add C++ script bodies to existing generated code\n");
 	fprintf(stderr, "    gen-C++	generate C++ script bodies\n");
+	fprintf(stderr, "    gen-C++-plugin	generate standalone C++ as a loadable plugin\n");
 	fprintf(stderr, "    gen-standalone-C++	generate \"standalone\" C++ script bodies\n");
 	fprintf(stderr, "    help	print this list\n");
 	fprintf(stderr, "    report-C++	report available C++ script bodies and exit\n");
@@ -236,10 +238,14 @@ static void set_analysis_option(const char* opt, Options& opts)
 		a_o.add_CPP = true;
 	else if ( util::streq(opt, "gen-C++") )
 		a_o.gen_CPP = true;
+	else if ( util::streq(opt, "gen-C++-plugin") )
+		a_o.gen_CPP_plugin = true;
 	else if ( util::streq(opt, "gen-standalone-C++") )
 		a_o.gen_standalone_CPP = true;
 	else if ( util::streq(opt, "gen-ZAM-code") )
 		a_o.activate = a_o.gen_ZAM_code = true;
+	else if ( util::streq(opt, "fuse-events") )
+		a_o.inliner = a_o.fuse_events = true;
 	else if ( util::streq(opt, "inline") )
 		a_o.inliner = true;
 	else if ( util::streq(opt, "no-ZAM-opt") )
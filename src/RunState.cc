@@ -19,6 +19,7 @@
 #include <signal.h>
 #include <stdlib.h>
 #include <unistd.h>
+#include <algorithm>
 
 extern "C"
 	{
@@ -31,8 +32,10 @@ extern "C"
 #include "zeek/NetVar.h"
 #include "zeek/Reporter.h"
 #include "zeek/Scope.h"
+#include "zeek/Stats.h"
 #include "zeek/Timer.h"
 #include "zeek/broker/Manager.h"
+#include "zeek/file_analysis/Manager.h"
 #include "zeek/iosource/Manager.h"
 #include "zeek/iosource/PktDumper.h"
 #include "zeek/iosource/PktSrc.h"
@@ -63,6 +66,7 @@ double current_wallclock = 0.0;
 double current_pseudo = 0.0;
 bool zeek_init_done = false;
 bool time_updated = false;
+LoadShedder* load_shedder = nullptr;
 
 RETSIGTYPE watchdog(int /* signo */)
 	{
@@ -203,11 +207,15 @@ void init_run(const std::optional<std::string>& interface,
 		(void)setsignal(SIGALRM, watchdog);
 		(void)alarm(zeek::detail::watchdog_interval);
 		}
+
+	if ( BifConst::LoadShedding::enable )
+		load_shedder = new LoadShedder();
 	}
 
 void expire_timers()
 	{
 	zeek::detail::SegmentProfiler prof(zeek::detail::segment_logger, "expiring-timers");
+	zeek::detail::PacketStageTimer stage_timer(zeek::detail::PacketStage::TimerAdvance);
 
 	current_dispatched += zeek::detail::timer_mgr->Advance(
 		network_time, zeek::detail::max_timer_expires - current_dispatched);
@@ -236,6 +244,9 @@ void dispatch_packet(Packet* pkt, iosource::PktSrc* pkt_src)
 	processing_start_time = t;
 	expire_timers();
 
+	if ( load_shedder )
+		load_shedder->Check(pkt, t, pkt_src);
+
 	zeek::detail::SegmentProfiler* sp = nullptr;
 
 	if ( load_sample )
@@ -256,8 +267,15 @@ void dispatch_packet(Packet* pkt, iosource::PktSrc* pkt_src)
 			}
 		}
 
-	packet_mgr->ProcessPacket(pkt);
-	event_mgr.Drain();
+		{
+		zeek::detail::PacketStageTimer timer(zeek::detail::PacketStage::Analyze);
+		packet_mgr->ProcessPacket(pkt);
+		}
+
+		{
+		zeek::detail::PacketStageTimer timer(zeek::detail::PacketStage::EventDrain);
+		event_mgr.Drain();
+		}
 
 	if ( sp )
 		{
@@ -286,6 +304,8 @@ void run_loop()
 	std::vector<iosource::IOSource*> ready;
 	ready.reserve(iosource_mgr->TotalSize());
 
+	zeek::detail::deferring_deletes = zeek::detail::max_deferred_deletes > 0;
+
 	while ( iosource_mgr->Size() || (BifConst::exit_only_after_terminate && ! terminating) )
 		{
 		time_updated = false;
@@ -347,6 +367,9 @@ void run_loop()
 		current_dispatched = 0;
 		current_iosrc = nullptr;
 
+		if ( zeek::detail::deferring_deletes )
+			zeek::detail::drain_deferred_deletes(zeek::detail::max_deferred_deletes);
+
 		if ( ::signal_val == SIGTERM || ::signal_val == SIGINT )
 			// We received a signal while processing the
 			// current packet and its related events.
@@ -372,6 +395,9 @@ void run_loop()
 			}
 		}
 
+	zeek::detail::deferring_deletes = false;
+	zeek::detail::drain_deferred_deletes(0);
+
 	// Get the final statistics now, and not when finish_run() is
 	// called, since that might happen quite a bit in the future
 	// due to expiring pending timers, and we don't want to ding
@@ -434,6 +460,9 @@ void delete_run()
 
 	for ( int i = 0; i < zeek::detail::NUM_ADDR_ANONYMIZATION_METHODS; ++i )
 		delete zeek::detail::ip_anonymizer[i];
+
+	delete load_shedder;
+	load_shedder = nullptr;
 	}
 
 double check_pseudo_time(const Packet* pkt)
@@ -450,6 +479,128 @@ iosource::PktSrc* current_packet_source()
 	return dynamic_cast<iosource::PktSrc*>(current_iosrc);
 	}
 
+LoadShedder::LoadShedder()
+	{
+	conn_sample_rate = BifConst::LoadShedding::conn_sample_rate;
+	orig_max_above_hole = zeek::detail::tcp_max_above_hole_without_any_acks;
+	orig_excessive_data = zeek::detail::tcp_excessive_data_without_further_acks;
+	}
+
+LoadShedder::~LoadShedder()
+	{
+	zeek::detail::tcp_max_above_hole_without_any_acks = orig_max_above_hole;
+	zeek::detail::tcp_excessive_data_without_further_acks = orig_excessive_data;
+	file_mgr->SetIgnoreNewFiles(false);
+	}
+
+void LoadShedder::DoCheck(const Packet* pkt, double t, iosource::PktSrc* src)
+	{
+	bool first_check = next_check == 0.0;
+	next_check = t + BifConst::LoadShedding::check_interval;
+
+	iosource::PktSrc::Stats stats;
+	src->Statistics(&stats);
+
+	// Counters may get reset, e.g. when the source is reopened.
+	uint64_t received = stats.received >= last_received ? stats.received - last_received
+	                                                    : stats.received;
+	uint64_t dropped = stats.dropped >= last_dropped ? stats.dropped - last_dropped
+	                                                 : stats.dropped;
+	last_received = stats.received;
+	last_dropped = stats.dropped;
+
+	if ( first_check )
+		{
+		// Nothing to compare the counters with yet.
+		auto min_level = std::min<uint64_t>(BifConst::LoadShedding::min_level, MAX_LEVEL);
+
+		if ( min_level > 0 )
+			SetLevel(min_level, 0.0, 0.0);
+
+		return;
+		}
+
+	// Without a real-time reference, such as when reading a trace as fast
+	// as possible, only drops count.
+	double lag = 0.0;
+
+	if ( pseudo_realtime )
+		{
+		if ( first_wallclock )
+			lag = util::current_time(true) -
+			      (first_wallclock + (pkt->time - first_timestamp) / pseudo_realtime);
+		}
+	else if ( reading_live )
+		lag = util::current_time() - pkt->time;
+
+	double drop_ratio = received + dropped ? double(dropped) / double(received + dropped) : 0.0;
+
+	Evaluate(lag, drop_ratio);
+	}
+
+uint64_t LoadShedder::Evaluate(double lag, double drop_ratio)
+	{
+	auto min_level = std::min<uint64_t>(BifConst::LoadShedding::min_level, MAX_LEVEL);
+
+	if ( lag > BifConst::LoadShedding::max_lag ||
+	     drop_ratio > BifConst::LoadShedding::max_drop_ratio )
+		{
+		healthy_checks = 0;
+
+		if ( level < MAX_LEVEL )
+			SetLevel(level + 1, lag, drop_ratio);
+		}
+
+	else if ( level > min_level &&
+	          ++healthy_checks >= BifConst::LoadShedding::recovery_checks )
+		{
+		healthy_checks = 0;
+		SetLevel(level - 1, lag, drop_ratio);
+		}
+
+	return level;
+	}
+
+void LoadShedder::SetLevel(uint64_t new_level, double lag, double drop_ratio)
+	{
+	auto old_level = level;
+	level = new_level;
+
+	auto limit = [](int orig) -> int
+		{
+		int reassembly_limit = BifConst::LoadShedding::reassembly_limit;
+
+		if ( ! reassembly_limit )
+			return orig;
+
+		// Zero disables the check altogether, so any limit is lower.
+		return orig ? std::min(orig, reassembly_limit) : reassembly_limit;
+		};
+
+	if ( level >= 1 )
+		{
+		zeek::detail::tcp_max_above_hole_without_any_acks = limit(orig_max_above_hole);
+		zeek::detail::tcp_excessive_data_without_further_acks = limit(orig_excessive_data);
+		}
+	else
+		{
+		zeek::detail::tcp_max_above_hole_without_any_acks = orig_max_above_hole;
+		zeek::detail::tcp_excessive_data_without_further_acks = orig_excessive_data;
+		}
+
+	file_mgr->SetIgnoreNewFiles(level >= 2);
+
+	reporter->Info("load shedding %s from level %" PRIu64 " to %" PRIu64
+	               " (lag %.3fs, %.2f%% of packets dropped)",
+	               level > old_level ? "raised" : "lowered", old_level, level, lag,
+	               drop_ratio * 100.0);
+
+	if ( load_shedding_level_changed )
+		event_mgr.Enqueue(load_shedding_level_changed, val_mgr->Count(old_level),
+		                  val_mgr->Count(level), make_intrusive<IntervalVal>(lag),
+		                  make_intrusive<DoubleVal>(drop_ratio));
+	}
+
 	} // namespace detail
 
 double current_packet_timestamp()
@@ -4,6 +4,7 @@
 
 #include "zeek/zeek-config.h"
 
+#include <cstdint>
 #include <optional>
 #include <string>
 
@@ -65,6 +66,77 @@ extern double current_pseudo;
 
 extern bool zeek_init_done;
 
+/**
+ * Sheds analysis work in steps while packet processing falls behind, as
+ * measured by how far it lags behind real time and by the drops the
+ * packet source reports.  See LoadShedding::enable for the levels.
+ */
+class LoadShedder
+	{
+public:
+	static constexpr uint64_t MAX_LEVEL = 3;
+
+	LoadShedder();
+
+	/**
+	 * Destructor.  Undoes whatever the current level changed.
+	 */
+	~LoadShedder();
+
+	/**
+	 * Called for every packet, checking for overload once per
+	 * LoadShedding::check_interval of packet time.
+	 * @param pkt the packet.
+	 * @param t the packet's timestamp as used for network time.
+	 * @param src the packet's source.
+	 */
+	void Check(const Packet* pkt, double t, iosource::PktSrc* src)
+		{
+		if ( t >= next_check )
+			DoCheck(pkt, t, src);
+		}
+
+	/**
+	 * Returns true if a new connection should get application-layer
+	 * analysis.
+	 */
+	bool AnalyzeNewConnection()
+		{
+		return level < 3 || (conn_sample_rate && ++new_connections % conn_sample_rate == 0);
+		}
+
+	/**
+	 * Raises or lowers the level according to what a check measured.
+	 * Called by Check(), and separately exposed for testing.
+	 * @param lag how far packet processing lags behind real time.
+	 * @param drop_ratio the fraction of packets the packet source
+	 * dropped since the previous check.
+	 * @return the resulting level.
+	 */
+	uint64_t Evaluate(double lag, double drop_ratio);
+
+	uint64_t Level() const { return level; }
+
+private:
+	void DoCheck(const Packet* pkt, double t, iosource::PktSrc* src);
+	void SetLevel(uint64_t new_level, double lag, double drop_ratio);
+
+	uint64_t level = 0;
+	uint64_t conn_sample_rate;
+	uint64_t new_connections = 0;
+	double next_check = 0.0;
+	uint64_t healthy_checks = 0;
+	uint64_t last_received = 0;
+	uint64_t last_dropped = 0;
+
+	// The reassembly limits in effect before level 1.
+	int orig_max_above_hole;
+	int orig_excessive_data;
+	};
+
+// Null unless LoadShedding::enable is set.
+extern LoadShedder* load_shedder;
+
 	} // namespace detail
 
 // Functions to temporarily suspend processing of live input (network packets
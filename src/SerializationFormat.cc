@@ -29,6 +29,7 @@ void SerializationFormat::StartRead(const char* data, uint32_t arg_len)
 	input_len = arg_len;
 	input_pos = 0;
 	bytes_read = 0;
+	read_error.clear();
 	}
 
 void SerializationFormat::EndRead()
@@ -68,8 +69,11 @@ bool SerializationFormat::ReadData(void* b, size_t count)
 	{
 	if ( input_pos + count > input_len )
 		{
-		reporter->Error("data underflow during read in binary format");
-		abort();
+		InputError("data underflow during read in binary format");
+
+		if ( ! quiet )
+			abort();
+
 		return false;
 		}
 
@@ -80,6 +84,14 @@ bool SerializationFormat::ReadData(void* b, size_t count)
 	return true;
 	}
 
+void SerializationFormat::InputError(const char* msg)
+	{
+	if ( ! quiet )
+		reporter->Error("%s", msg);
+	else if ( read_error.empty() )
+		read_error = msg;
+	}
+
 bool SerializationFormat::WriteData(const void* b, size_t count)
 	{
 	// Increase buffer if necessary.
@@ -195,6 +207,13 @@ bool BinarySerializationFormat::Read(char** str, int* len, const char* tag)
 		return false;
 
 	l = ntohl(l);
+
+	if ( l < 0 || static_cast<uint32_t>(l) > BytesLeft() )
+		{
+		InputError("invalid string length during read in binary format");
+		return false;
+		}
+
 	char* s = new char[l + 1];
 
 	if ( ! ReadData(s, l) )
@@ -213,7 +232,7 @@ bool BinarySerializationFormat::Read(char** str, int* len, const char* tag)
 		for ( int i = 0; i < l; i++ )
 			if ( ! s[i] )
 				{
-				reporter->Error("binary Format: string contains null; replaced by '_'");
+				InputError("binary Format: string contains null; replaced by '_'");
 				s[i] = '_';
 				}
 		}
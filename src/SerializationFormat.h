@@ -47,6 +47,18 @@ public:
 	// Returns number of raw bytes read since last call to StartRead().
 	int BytesRead() const { return bytes_read; }
 
+	// Returns the number of raw bytes left to read.
+	uint32_t BytesLeft() const { return input_len - input_pos; }
+
+	// Has reads keep problems with the input to themselves rather than
+	// reporting them, and fail rather than abort when running out of
+	// input.  That makes reading usable outside of the main thread.
+	void SetQuiet() { quiet = true; }
+
+	// When quiet, describes the first problem with the input that reads
+	// ran into since the last call to StartRead(), if any.
+	const std::string& ReadError() const { return read_error; }
+
 	// Passes ownership of string.
 	virtual bool Read(char** str, int* len, const char* tag) = 0;
 
@@ -89,6 +101,9 @@ protected:
 	bool ReadData(void* buf, size_t count);
 	bool WriteData(const void* buf, size_t count);
 
+	// Reports a problem with the input, or records it when quiet.
+	void InputError(const char* msg);
+
 	static const uint32_t INITIAL_SIZE = 65536;
 	static const float GROWTH_FACTOR;
 	char* output;
@@ -101,6 +116,9 @@ protected:
 
 	int bytes_written;
 	int bytes_read;
+
+	bool quiet = false;
+	std::string read_error;
 	};
 
 class BinarySerializationFormat final : public SerializationFormat
@@ -16,6 +16,7 @@
 #include "zeek/packet_analysis/protocol/tcp/TCP.h"
 #include "zeek/session/Manager.h"
 #include "zeek/threading/Manager.h"
+#include "zeek/telemetry/Manager.h"
 
 uint64_t zeek::detail::killed_by_inactivity = 0;
 uint64_t& killed_by_inactivity = zeek::detail::killed_by_inactivity;
@@ -481,4 +482,72 @@ void PacketProfiler::ProfilePkt(double t, unsigned int bytes)
 	time = t;
 	}
 
+static double calibrate_profile_ticks()
+	{
+	using Clock = std::chrono::steady_clock;
+	auto start_time = Clock::now();
+	auto start_ticks = profile_ticks();
+	auto elapsed = Clock::duration::zero();
+
+	while ( elapsed < std::chrono::milliseconds(10) )
+		elapsed = Clock::now() - start_time;
+
+	auto ticks = profile_ticks() - start_ticks;
+	return std::chrono::duration<double>(elapsed).count() / (ticks ? ticks : 1);
+	}
+
+double profile_seconds_per_tick()
+	{
+	static double seconds_per_tick = calibrate_profile_ticks();
+	return seconds_per_tick;
+	}
+
+PacketStageProfiler::PacketStageProfiler(uint64_t arg_sample_rate)
+	: sample_rate(arg_sample_rate), seconds_per_tick(profile_seconds_per_tick())
+	{
+	static const char* stage_names[] = {"extract",       "analyze",          "session-lookup",
+	                                    "reassembly",    "analyzer-delivery", "event-drain",
+	                                    "timer-advance"};
+	static_assert(sizeof(stage_names) / sizeof(stage_names[0]) ==
+	              static_cast<size_t>(PacketStage::NUM_STAGES));
+
+	// Buckets range from 1us to 100ms.
+	static const double bounds[] = {0.000001, 0.00001, 0.0001, 0.001, 0.01, 0.1};
+	auto family = telemetry_mgr->HistogramFamily<double>(
+		"zeek", "packet-stage-time", {"stage"}, bounds,
+		"Time sampled packets spent in the stages of their processing", "seconds");
+
+	for ( auto name : stage_names )
+		histograms.emplace_back(family.GetOrAdd({{"stage", name}}));
+	}
+
+AnalyzerCostProfiler::AnalyzerCostProfiler(uint64_t arg_sample_rate)
+	: sample_rate(arg_sample_rate), seconds_per_tick(profile_seconds_per_tick())
+	{
+	}
+
+AnalyzerMetrics* AnalyzerCostProfiler::Metrics(const char* kind, const char* name)
+	{
+	auto& m = metrics[{kind, name}];
+
+	if ( ! m )
+		{
+		auto cpu_time = telemetry_mgr->CounterFamily<double>(
+			"zeek", "analyzer-cpu-time", {"kind", "analyzer"},
+			"Estimated CPU time analyzers spent on the data delivered to them", "seconds", true);
+		auto bytes = telemetry_mgr->CounterFamily(
+			"zeek", "analyzer-delivered-bytes", {"kind", "analyzer"},
+			"Bytes delivered to analyzers", "bytes", true);
+		auto instances = telemetry_mgr->GaugeFamily(
+			"zeek", "analyzer-instances", {"kind", "analyzer"},
+			"Live analyzers that have seen data");
+
+		std::initializer_list<telemetry::LabelView> labels = {{"kind", kind}, {"analyzer", name}};
+		m = std::make_unique<AnalyzerMetrics>(AnalyzerMetrics{
+			cpu_time.GetOrAdd(labels), bytes.GetOrAdd(labels), instances.GetOrAdd(labels)});
+		}
+
+	return m.get();
+	}
+
 	} // namespace zeek::detail
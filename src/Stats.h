@@ -8,6 +8,19 @@
 #include <sys/resource.h>
 #include <sys/time.h>
 #include <sys/types.h>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "zeek/telemetry/Counter.h"
+#include "zeek/telemetry/Gauge.h"
+#include "zeek/telemetry/Histogram.h"
 
 namespace zeek
 	{
@@ -142,5 +155,181 @@ protected:
 	uint64_t byte_cnt;
 	};
 
+// Returns the current value of the clock used for timing by the
+// profilers below.  This is the CPU's cycle counter where available, so
+// that the measurements themselves add little overhead.
+inline uint64_t profile_ticks()
+	{
+#if defined(__x86_64__) || defined(__i386__)
+	return __rdtsc();
+#else
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(
+			   std::chrono::steady_clock::now().time_since_epoch())
+	    .count();
+#endif
+	}
+
+// Returns the length of one of profile_ticks()'s ticks in seconds,
+// calibrating it against the system's clock on first use.
+double profile_seconds_per_tick();
+
+// The stages of packet processing timed by the PacketStageProfiler.
+// Stages nest, e.g. analyzers receive data within TCP reassembly, which
+// happens within packet analysis, and the time of each stage includes
+// that of the stages within it.
+enum class PacketStage
+	{
+	Extract, // Getting the next packet from the packet source.
+	Analyze, // packet_analysis::Manager::ProcessPacket().
+	SessionLookup, // Finding the connection a packet belongs to.
+	Reassembly, // TCP reassembly, including delivering data in order.
+	AnalyzerDelivery, // Analyzers' DeliverStream().
+	EventDrain, // Draining the events raised for a packet.
+	TimerAdvance, // Expiring timers before processing a packet.
+	NUM_STAGES
+	};
+
+// Measures how long every Nth packet spends in each stage of its
+// processing and records that in telemetry histograms.
+class PacketStageProfiler
+	{
+public:
+	explicit PacketStageProfiler(uint64_t sample_rate);
+
+	// Called when starting on and done with a packet, respectively.
+	void StartPacket() { sampling = ++num_packets % sample_rate == 0; }
+	void FinishPacket() { sampling = false; }
+
+	// Returns whether the current packet is sampled.
+	bool Sampling() const { return sampling; }
+
+	// Begins timing a stage if the current packet is sampled and the
+	// stage isn't being timed already further up the call stack.
+	// Returns the start time, or 0 if not timing.
+	uint64_t Begin(PacketStage stage)
+		{
+		auto i = static_cast<size_t>(stage);
+
+		if ( ! sampling || active[i] )
+			return 0;
+
+		active[i] = true;
+		return profile_ticks();
+		}
+
+	// Records a stage's time.  The start is what Begin() returned.
+	void End(PacketStage stage, uint64_t start)
+		{
+		auto i = static_cast<size_t>(stage);
+		active[i] = false;
+		histograms[i].Observe((profile_ticks() - start) * seconds_per_tick);
+		}
+
+private:
+	uint64_t sample_rate;
+	uint64_t num_packets = 0;
+	bool sampling = false;
+	bool active[static_cast<size_t>(PacketStage::NUM_STAGES)] = {};
+	double seconds_per_tick;
+	std::vector<telemetry::DblHistogram> histograms;
+	};
+
+extern PacketStageProfiler* packet_stage_profiler;
+
+// Times a stage of processing the current packet for the
+// PacketStageProfiler across its lifetime, if there is one.
+class PacketStageTimer
+	{
+public:
+	explicit PacketStageTimer(PacketStage arg_stage) : stage(arg_stage)
+		{
+		if ( packet_stage_profiler )
+			start = packet_stage_profiler->Begin(stage);
+		}
+
+	~PacketStageTimer()
+		{
+		if ( start )
+			packet_stage_profiler->End(stage, start);
+		}
+
+private:
+	PacketStage stage;
+	uint64_t start = 0;
+	};
+
+// The telemetry the AnalyzerCostProfiler maintains for each type of
+// analyzer.
+struct AnalyzerMetrics
+	{
+	telemetry::DblCounter cpu_time; // Estimated from the sampled deliveries.
+	telemetry::IntCounter bytes; // Delivered to the analyzers.
+	telemetry::IntGauge instances; // Live analyzers that have seen data.
+	};
+
+// Estimates the CPU time protocol and file analyzers spend on the data
+// delivered to them by timing every Nth delivery that doesn't happen
+// within another one.  Time spent in analyzers that an analyzer passes
+// data on to is attributed to those, not to the analyzer itself.
+class AnalyzerCostProfiler
+	{
+public:
+	explicit AnalyzerCostProfiler(uint64_t sample_rate);
+
+	// Returns the metrics for a type of analyzer.  The kind is either
+	// "protocol" or "file".
+	AnalyzerMetrics* Metrics(const char* kind, const char* name);
+
+	// Called when starting to deliver data to an analyzer.  Returns the
+	// start time if timing the delivery, or 0 if not.
+	uint64_t Begin()
+		{
+		if ( depth++ == 0 )
+			sampling = ++num_deliveries % sample_rate == 0;
+
+		if ( ! sampling )
+			return 0;
+
+		child_ticks.push_back(0);
+		return profile_ticks();
+		}
+
+	// Called when done delivering data to an analyzer, with what the
+	// corresponding Begin() returned.  Returns the estimated CPU time
+	// the analyzer itself took, scaled up by the sample rate, or 0 if
+	// the delivery wasn't timed.
+	double End(uint64_t start)
+		{
+		--depth;
+
+		if ( ! start )
+			return 0.0;
+
+		auto elapsed = profile_ticks() - start;
+		auto self = elapsed - child_ticks.back();
+		child_ticks.pop_back();
+
+		if ( ! child_ticks.empty() )
+			child_ticks.back() += elapsed;
+
+		return self * seconds_per_tick * sample_rate;
+		}
+
+private:
+	uint64_t sample_rate;
+	uint64_t num_deliveries = 0;
+	int depth = 0;
+	bool sampling = false;
+	double seconds_per_tick;
+
+	// For each timed delivery in progress, the time spent in those
+	// nested within it.
+	std::vector<uint64_t> child_ticks;
+
+	std::map<std::pair<std::string, std::string>, std::unique_ptr<AnalyzerMetrics>> metrics;
+	};
+
+extern AnalyzerCostProfiler* analyzer_cost_profiler;
+
 	} // namespace detail
 	} // namespace zeek
@@ -50,6 +50,7 @@ const char* TimerNames[] = {
 	"TimerMgrExpireTimer",
 	"ThreadHeartbeat",
 	"UnknownProtocolExpire",
+	"BrokerSnapshotReconcileTimer",
 };
 
 const char* timer_type_to_string(TimerType type)
@@ -51,8 +51,9 @@ enum TimerType : uint8_t
 	TIMER_TIMERMGR_EXPIRE,
 	TIMER_THREAD_HEARTBEAT,
 	TIMER_UNKNOWN_PROTOCOL_EXPIRE,
+	TIMER_BROKER_SNAPSHOT_RECONCILE,
 	};
-constexpr int NUM_TIMER_TYPES = int(TIMER_UNKNOWN_PROTOCOL_EXPIRE) + 1;
+constexpr int NUM_TIMER_TYPES = int(TIMER_BROKER_SNAPSHOT_RECONCILE) + 1;
 
 extern const char* timer_type_to_string(TimerType type);
 
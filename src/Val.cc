@@ -249,7 +249,7 @@ ValPtr Val::SizeVal() const
 			return val_mgr->Count(AsCount());
 
 		case TYPE_INTERNAL_DOUBLE:
-			return make_intrusive<DoubleVal>(fabs(AsDouble()));
+			return val_mgr->Double(fabs(AsDouble()));
 
 		default:
 			break;
@@ -880,7 +880,7 @@ unsigned int SubNetVal::MemoryAllocation() const
 ValPtr SubNetVal::SizeVal() const
 	{
 	int retained = 128 - subnet_val->LengthIPv6();
-	return make_intrusive<DoubleVal>(pow(2.0, double(retained)));
+	return val_mgr->Double(pow(2.0, double(retained)));
 	}
 
 void SubNetVal::ValDescribe(ODesc* d) const
@@ -1127,7 +1127,7 @@ FileVal::FileVal(FilePtr f) : Val(make_intrusive<FileType>(base_type(TYPE_STRING
 
 ValPtr FileVal::SizeVal() const
 	{
-	return make_intrusive<DoubleVal>(file_val->Size());
+	return val_mgr->Double(file_val->Size());
 	}
 
 void FileVal::ValDescribe(ODesc* d) const
@@ -1349,7 +1349,10 @@ void TableValTimer::Dispatch(double t, bool is_expire)
 	if ( ! is_expire )
 		{
 		table->ClearTimer(this);
-		table->DoExpire(t);
+
+		// The table may be awaiting deferred deletion.
+		if ( table->RefCnt() > 0 )
+			table->DoExpire(t);
 		}
 	}
 
@@ -3827,10 +3830,10 @@ check_and_promote(ValPtr v, const Type* t, bool is_init, const detail::Location*
 			switch ( t_tag )
 				{
 				case TYPE_DOUBLE:
-					promoted_v = make_intrusive<DoubleVal>(v->CoerceToDouble());
+					promoted_v = val_mgr->Double(v->CoerceToDouble());
 					break;
 				case TYPE_INTERVAL:
-					promoted_v = make_intrusive<IntervalVal>(v->CoerceToDouble());
+					promoted_v = val_mgr->Interval(v->CoerceToDouble());
 					break;
 				case TYPE_TIME:
 					promoted_v = make_intrusive<TimeVal>(v->CoerceToDouble());
@@ -4021,17 +4024,58 @@ ValPtr Val::MakeCount(bro_uint_t u)
 	return make_intrusive<CountVal>(u);
 	}
 
+ValPtr Val::MakeDouble(double d)
+	{
+	return make_intrusive<DoubleVal>(d);
+	}
+
+ValPtr Val::MakeInterval(double d)
+	{
+	return make_intrusive<IntervalVal>(d);
+	}
+
+// Returns the size given by the environment variable, or the default
+// if it's not set (or not a number).
+static bro_uint_t val_cache_size(const char* env_var, bro_uint_t dflt)
+	{
+	auto e = getenv(env_var);
+	if ( ! e )
+		return dflt;
+
+	char* end;
+	auto n = strtoull(e, &end, 10);
+	if ( end == e || *end )
+		return dflt;
+
+	return n;
+	}
+
 ValManager::ValManager()
 	{
 	empty_string = make_intrusive<StringVal>("");
 	b_false = Val::MakeBool(false);
 	b_true = Val::MakeBool(true);
 
-	for ( auto i = 0u; i < PREALLOCATED_COUNTS; ++i )
-		counts[i] = Val::MakeCount(i);
+	auto num_counts = val_cache_size("ZEEK_VAL_CACHE_COUNTS", PREALLOCATED_COUNTS);
+	counts.reserve(num_counts);
+
+	for ( bro_uint_t i = 0; i < num_counts; ++i )
+		counts.emplace_back(Val::MakeCount(i));
+
+	auto num_ints = val_cache_size("ZEEK_VAL_CACHE_INTS", PREALLOCATED_INTS);
+
+	int_lowest = 1 - static_cast<bro_int_t>(num_ints / 2);
+	int_highest = int_lowest + static_cast<bro_int_t>(num_ints) - 1;
+	ints.reserve(num_ints);
+
+	for ( auto i = 0u; i < num_ints; ++i )
+		ints.emplace_back(Val::MakeInt(int_lowest + i));
+
+	for ( auto i = 0u; i < doubles.size(); ++i )
+		doubles[i] = Val::MakeDouble(i);
 
-	for ( auto i = 0u; i < PREALLOCATED_INTS; ++i )
-		ints[i] = Val::MakeInt(PREALLOCATED_INT_LOWEST + i);
+	for ( auto i = 0u; i < intervals.size(); ++i )
+		intervals[i] = Val::MakeInterval(i);
 
 	for ( auto i = 0u; i < ports.size(); ++i )
 		{
@@ -4,6 +4,7 @@
 
 #include <sys/types.h> // for u_char
 #include <array>
+#include <cmath>
 #include <list>
 #include <unordered_map>
 #include <vector>
@@ -239,8 +240,10 @@ protected:
 	static ValPtr MakeBool(bool b);
 	static ValPtr MakeInt(bro_int_t i);
 	static ValPtr MakeCount(bro_uint_t u);
+	static ValPtr MakeDouble(double d);
+	static ValPtr MakeInterval(double d);
 
-	explicit Val(TypePtr t) noexcept : type(std::move(t)) { }
+	explicit Val(TypePtr t) noexcept : type(std::move(t)) { AllowDeferredDelete(); }
 
 	// For internal use by the Val::Clone() methods.
 	struct CloneState
@@ -269,12 +272,22 @@ protected:
 class ValManager
 	{
 public:
+	// Default sizes of the ranges of preallocated counts and integers.
+	// These can be changed via the ZEEK_VAL_CACHE_COUNTS and
+	// ZEEK_VAL_CACHE_INTS environment variables; integers are then
+	// preallocated for a range of the given size that's (nearly)
+	// centered on zero.
 	static constexpr bro_uint_t PREALLOCATED_COUNTS = 4096;
 	static constexpr bro_uint_t PREALLOCATED_INTS = 512;
 	static constexpr bro_int_t PREALLOCATED_INT_LOWEST = -255;
 	static constexpr bro_int_t PREALLOCATED_INT_HIGHEST = PREALLOCATED_INT_LOWEST +
 	                                                      PREALLOCATED_INTS - 1;
 
+	// Doubles are preallocated for the whole numbers below this, and
+	// intervals for whole numbers of seconds up to an hour.
+	static constexpr bro_uint_t PREALLOCATED_DOUBLES = 1024;
+	static constexpr bro_uint_t PREALLOCATED_INTERVAL_SECS = 3601;
+
 	ValManager();
 
 	inline const ValPtr& True() const { return b_true; }
@@ -285,14 +298,26 @@ public:
 
 	inline ValPtr Int(int64_t i) const
 		{
-		return i < PREALLOCATED_INT_LOWEST || i > PREALLOCATED_INT_HIGHEST
-		           ? Val::MakeInt(i)
-		           : ints[i - PREALLOCATED_INT_LOWEST];
+		return i < int_lowest || i > int_highest ? Val::MakeInt(i) : ints[i - int_lowest];
 		}
 
 	inline ValPtr Count(uint64_t i) const
 		{
-		return i >= PREALLOCATED_COUNTS ? Val::MakeCount(i) : counts[i];
+		return i >= counts.size() ? Val::MakeCount(i) : counts[i];
+		}
+
+	inline ValPtr Double(double d) const
+		{
+		return IsPreallocatedWhole(d, PREALLOCATED_DOUBLES) ? doubles[static_cast<size_t>(d)]
+		                                                   : Val::MakeDouble(d);
+		}
+
+	// Takes the interval in seconds.
+	inline ValPtr Interval(double secs) const
+		{
+		return IsPreallocatedWhole(secs, PREALLOCATED_INTERVAL_SECS)
+		           ? intervals[static_cast<size_t>(secs)]
+		           : Val::MakeInterval(secs);
 		}
 
 	inline const StringValPtr& EmptyString() const { return empty_string; }
@@ -304,9 +329,21 @@ public:
 	const PortValPtr& Port(uint32_t port_num) const;
 
 private:
+	// Whether the given double is one of 0.0, 1.0, ..., n - 1.  Rules
+	// out -0.0, which prints differently than 0.0.
+	static bool IsPreallocatedWhole(double d, bro_uint_t n)
+		{
+		return d >= 0.0 && d < n && static_cast<double>(static_cast<bro_uint_t>(d)) == d &&
+		       ! std::signbit(d);
+		}
+
 	std::array<std::array<PortValPtr, 65536>, NUM_PORT_SPACES> ports;
-	std::array<ValPtr, PREALLOCATED_COUNTS> counts;
-	std::array<ValPtr, PREALLOCATED_INTS> ints;
+	std::vector<ValPtr> counts;
+	std::vector<ValPtr> ints;
+	bro_int_t int_lowest;
+	bro_int_t int_highest;
+	std::array<ValPtr, PREALLOCATED_DOUBLES> doubles;
+	std::array<ValPtr, PREALLOCATED_INTERVAL_SECS> intervals;
 	StringValPtr empty_string;
 	ValPtr b_true;
 	ValPtr b_false;
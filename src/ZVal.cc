@@ -207,10 +207,10 @@ ValPtr ZVal::ToVal(const TypePtr& t) const
 			return val_mgr->Count(uint_val);
 
 		case TYPE_DOUBLE:
-			return make_intrusive<DoubleVal>(double_val);
+			return val_mgr->Double(double_val);
 
 		case TYPE_INTERVAL:
-			return make_intrusive<IntervalVal>(double_val, Seconds);
+			return val_mgr->Interval(double_val);
 
 		case TYPE_TIME:
 			return make_intrusive<TimeVal>(double_val);
@@ -5,7 +5,9 @@
 #include <binpac.h>
 #include <algorithm>
 
+#include "zeek/Conn.h"
 #include "zeek/Event.h"
+#include "zeek/Stats.h"
 #include "zeek/ZeekString.h"
 #include "zeek/analyzer/Manager.h"
 #include "zeek/analyzer/protocol/pia/PIA.h"
@@ -164,6 +166,9 @@ Analyzer::~Analyzer()
 		}
 
 	delete output_handler;
+
+	if ( cost_metrics )
+		cost_metrics->instances.Dec();
 	}
 
 void Analyzer::Init() { }
@@ -223,6 +228,7 @@ void Analyzer::NextPacket(int len, const u_char* data, bool is_orig, uint64_t se
 		{
 		try
 			{
+			DeliveryCost cost(this, len);
 			DeliverPacket(len, data, is_orig, seq, ip, caplen);
 			}
 		catch ( binpac::Exception const& e )
@@ -246,6 +252,8 @@ void Analyzer::NextStream(int len, const u_char* data, bool is_orig)
 		{
 		try
 			{
+			zeek::detail::PacketStageTimer timer(zeek::detail::PacketStage::AnalyzerDelivery);
+			DeliveryCost cost(this, len);
 			DeliverStream(len, data, is_orig);
 			}
 		catch ( binpac::Exception const& e )
@@ -824,6 +832,44 @@ const RecordValPtr& Analyzer::ConnVal()
 	return conn->GetVal();
 	}
 
+DeliveryCost::DeliveryCost(Analyzer* arg_analyzer, int len)
+	{
+	if ( ! zeek::detail::analyzer_cost_profiler || ! arg_analyzer )
+		return;
+
+	analyzer = arg_analyzer;
+	analyzer->CostMetrics()->bytes.Inc(len);
+	start = zeek::detail::analyzer_cost_profiler->Begin();
+	}
+
+DeliveryCost::~DeliveryCost()
+	{
+	if ( ! analyzer )
+		return;
+
+	auto cpu_time = zeek::detail::analyzer_cost_profiler->End(start);
+
+	if ( cpu_time <= 0 )
+		return;
+
+	analyzer->CostMetrics()->cpu_time.Inc(cpu_time);
+
+	if ( analyzer->Conn() )
+		analyzer->Conn()->AddAnalyzerCPUTime(analyzer->GetAnalyzerTag(), cpu_time);
+	}
+
+zeek::detail::AnalyzerMetrics* Analyzer::CostMetrics()
+	{
+	if ( ! cost_metrics )
+		{
+		cost_metrics = zeek::detail::analyzer_cost_profiler->Metrics("protocol",
+		                                                             GetAnalyzerName());
+		cost_metrics->instances.Inc();
+		}
+
+	return cost_metrics;
+	}
+
 void Analyzer::Event(EventHandlerPtr f, const char* name)
 	{
 	conn->Event(f, this, name);
@@ -868,8 +914,11 @@ void SupportAnalyzer::ForwardPacket(int len, const u_char* data, bool is_orig, u
 		// Pass to next in chain.
 		next_sibling->NextPacket(len, data, is_orig, seq, ip, caplen);
 	else
+		{
 		// Finished with preprocessing - now it's the parent's turn.
+		DeliveryCost cost(Parent(), len);
 		Parent()->DeliverPacket(len, data, is_orig, seq, ip, caplen);
+		}
 	}
 
 void SupportAnalyzer::ForwardStream(int len, const u_char* data, bool is_orig)
@@ -888,8 +937,11 @@ void SupportAnalyzer::ForwardStream(int len, const u_char* data, bool is_orig)
 		// Pass to next in chain.
 		next_sibling->NextStream(len, data, is_orig);
 	else
+		{
 		// Finished with preprocessing - now it's the parent's turn.
+		DeliveryCost cost(Parent(), len);
 		Parent()->DeliverStream(len, data, is_orig);
+		}
 	}
 
 void SupportAnalyzer::ForwardUndelivered(uint64_t seq, int len, bool is_orig)
@@ -26,6 +26,7 @@ using RecordValPtr = zeek::IntrusivePtr<RecordVal>;
 namespace detail
 	{
 class Rule;
+struct AnalyzerMetrics;
 	}
 namespace packet_analysis::IP
 	{
@@ -616,6 +617,13 @@ public:
 	 */
 	const RecordValPtr& ConnVal();
 
+	/**
+	 * Returns the telemetry kept for the analyzer's type when
+	 * :zeek:see:`analyzer_cost_sample_rate` is set.  Must only be called
+	 * when that's the case.
+	 */
+	zeek::detail::AnalyzerMetrics* CostMetrics();
+
 	/**
 	 * Convenience function that forwards directly to the corresponding
 	 * Connection::Event().
@@ -778,9 +786,36 @@ private:
 	bool finished;
 	bool removing;
 
+	zeek::detail::AnalyzerMetrics* cost_metrics = nullptr;
+
 	static ID id_counter;
 	};
 
+/**
+ * Accounts a delivery of data to an analyzer across its lifetime, if
+ * :zeek:see:`analyzer_cost_sample_rate` is set.  Deliveries through
+ * NextPacket() and NextStream() are accounted automatically; this is for
+ * code that calls an analyzer's DeliverPacket() or DeliverStream()
+ * directly.
+ */
+class DeliveryCost
+	{
+public:
+	/**
+	 * Constructor.
+	 *
+	 * @param analyzer The analyzer receiving the data; may be null.
+	 *
+	 * @param len The number of bytes delivered.
+	 */
+	DeliveryCost(Analyzer* analyzer, int len);
+	~DeliveryCost();
+
+private:
+	Analyzer* analyzer = nullptr;
+	uint64_t start = 0;
+	};
+
 /**
  * Convenience macro to add a new timer.
  */
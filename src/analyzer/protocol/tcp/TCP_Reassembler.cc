@@ -5,6 +5,7 @@
 #include "zeek/File.h"
 #include "zeek/Reporter.h"
 #include "zeek/RuleMatcher.h"
+#include "zeek/Stats.h"
 #include "zeek/ZeekString.h"
 #include "zeek/analyzer/Analyzer.h"
 #include "zeek/analyzer/protocol/tcp/TCP.h"
@@ -456,6 +457,8 @@ void TCP_Reassembler::Deliver(uint64_t seq, int len, const u_char* data)
 bool TCP_Reassembler::DataSent(double t, uint64_t seq, int len, const u_char* data,
                                TCP_Flags arg_flags, bool replaying)
 	{
+	zeek::detail::PacketStageTimer stage_timer(zeek::detail::PacketStage::Reassembly);
+
 	uint64_t ack = endp->ToRelativeSeqSpace(endp->AckSeq(), endp->AckWraps());
 	uint64_t upper_seq = seq + len;
 
@@ -623,6 +626,16 @@ void TCP_Reassembler::SkipToSeq(uint64_t seq)
 		}
 	}
 
+void TCP_Reassembler::StopDeliveries()
+	{
+	skip_deliveries = true;
+
+	// While delivering, the blocks are still being iterated over, and
+	// are released as they get acknowledged instead.
+	if ( ! in_delivery )
+		ClearBlocks();
+	}
+
 bool TCP_Reassembler::DataPending() const
 	{
 	// If we are skipping deliveries, the reassembler will not get called
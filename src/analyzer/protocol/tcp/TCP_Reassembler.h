@@ -72,6 +72,10 @@ public:
 	// Can be used to skip HTTP data for performance considerations.
 	void SkipToSeq(uint64_t seq);
 
+	// Stops reassembling and delivering any further data, releasing
+	// what's buffered.
+	void StopDeliveries();
+
 	bool DataSent(double t, uint64_t seq, int len, const u_char* data,
 	              analyzer::tcp::TCP_Flags flags, bool replaying = true);
 	void AckReceived(uint64_t seq);
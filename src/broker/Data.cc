@@ -1,12 +1,17 @@
 #include "zeek/broker/Data.h"
 
 #include <broker/error.hh>
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
 
 #include "zeek/3rdparty/doctest.h"
 #include "zeek/Desc.h"
 #include "zeek/File.h"
 #include "zeek/Func.h"
+#include "zeek/Hash.h"
 #include "zeek/ID.h"
+#include "zeek/IPAddr.h"
 #include "zeek/IntrusivePtr.h"
 #include "zeek/RE.h"
 #include "zeek/Scope.h"
@@ -123,7 +128,7 @@ struct val_converter
 	result_type operator()(double a)
 		{
 		if ( type->Tag() == TYPE_DOUBLE )
-			return make_intrusive<DoubleVal>(a);
+			return val_mgr->Double(a);
 		return nullptr;
 		}
 
@@ -194,7 +199,7 @@ struct val_converter
 
 		using namespace std::chrono;
 		auto s = duration_cast<broker::fractional_seconds>(a);
-		return make_intrusive<IntervalVal>(s.count());
+		return val_mgr->Interval(s.count());
 		}
 
 	result_type operator()(broker::enum_value& a)
@@ -1335,6 +1340,660 @@ bool RecordIterator::DoUnserialize(const broker::data& data)
 	return true;
 	}
 
+// Event arguments encoded by pack_event_args() travel as a vector of this
+// marker, the number of arguments, a fingerprint of their types, and the
+// blob holding their values.
+static constexpr const char* packed_event_args_marker = "Broker::PACKED_EVENT_ARGS";
+
+// Writes values in the packed encoding.  Integers use a variable-length
+// encoding (zigzag-encoded first if signed) so that small values take a
+// single byte, doubles are their bit patterns in little-endian order, and
+// addresses are always 16 bytes in network order.  Containers start with
+// their number of elements, and record fields and vector elements with a
+// flag telling whether they're present.
+class ValPacker
+	{
+public:
+	bool Pack(const Val* v, const Type* t);
+
+	std::string& Buffer() { return buf; }
+
+private:
+	void PackUInt(uint64_t u)
+		{
+		while ( u >= 0x80 )
+			{
+			buf.push_back(static_cast<char>(u | 0x80));
+			u >>= 7;
+			}
+
+		buf.push_back(static_cast<char>(u));
+		}
+
+	void PackInt(int64_t i)
+		{
+		PackUInt((static_cast<uint64_t>(i) << 1) ^ static_cast<uint64_t>(i >> 63));
+		}
+
+	void PackDouble(double d)
+		{
+		uint64_t u;
+		memcpy(&u, &d, sizeof(u));
+
+		for ( int i = 0; i < 8; ++i, u >>= 8 )
+			buf.push_back(static_cast<char>(u & 0xff));
+		}
+
+	void PackBytes(const void* data, size_t len)
+		{
+		PackUInt(len);
+		buf.append(static_cast<const char*>(data), len);
+		}
+
+	void PackAddr(const IPAddr& a)
+		{
+		in6_addr in6;
+		a.CopyIPv6(&in6);
+		buf.append(reinterpret_cast<const char*>(&in6), sizeof(in6));
+		}
+
+	std::string buf;
+	};
+
+bool ValPacker::Pack(const Val* v, const Type* t)
+	{
+	if ( v->GetType()->Tag() != t->Tag() )
+		return false;
+
+	switch ( t->Tag() )
+		{
+		case TYPE_BOOL:
+		case TYPE_INT:
+			PackInt(v->InternalInt());
+			return true;
+
+		case TYPE_COUNT:
+		case TYPE_PORT:
+			PackUInt(v->InternalUnsigned());
+			return true;
+
+		case TYPE_DOUBLE:
+		case TYPE_TIME:
+		case TYPE_INTERVAL:
+			PackDouble(v->InternalDouble());
+			return true;
+
+		case TYPE_ENUM:
+			{
+			auto name = t->AsEnumType()->Lookup(v->InternalInt());
+
+			if ( ! name )
+				return false;
+
+			PackBytes(name, strlen(name));
+			return true;
+			}
+
+		case TYPE_STRING:
+			{
+			auto s = v->AsString();
+			PackBytes(s->Bytes(), s->Len());
+			return true;
+			}
+
+		case TYPE_ADDR:
+			PackAddr(v->AsAddr());
+			return true;
+
+		case TYPE_SUBNET:
+			{
+			const auto& sn = v->AsSubNet();
+			PackAddr(sn.Prefix());
+			PackUInt(sn.LengthIPv6());
+			return true;
+			}
+
+		case TYPE_RECORD:
+			{
+			auto rt = t->AsRecordType();
+			auto rv = v->AsRecordVal();
+
+			for ( auto i = 0; i < rt->NumFields(); ++i )
+				{
+				auto f = rv->GetField(i);
+				PackUInt(f ? 1 : 0);
+
+				if ( f && ! Pack(f.get(), rt->GetFieldType(i).get()) )
+					return false;
+				}
+
+			return true;
+			}
+
+		case TYPE_TABLE:
+			{
+			auto tt = t->AsTableType();
+			auto tv = v->AsTableVal();
+			const auto& index_types = tt->GetIndexTypes();
+			auto is_set = tt->IsSet();
+
+			PackUInt(tv->Size());
+
+			for ( const auto& te : *v->AsTable() )
+				{
+				auto hk = te.GetHashKey();
+				auto idx = tv->RecreateIndex(*hk);
+
+				if ( idx->Length() != static_cast<int>(index_types.size()) )
+					return false;
+
+				for ( auto i = 0; i < idx->Length(); ++i )
+					if ( ! Pack(idx->Idx(i).get(), index_types[i].get()) )
+						return false;
+
+				if ( ! is_set )
+					{
+					auto entry = te.GetValue<TableEntryVal*>();
+
+					if ( ! Pack(entry->GetVal().get(), tt->Yield().get()) )
+						return false;
+					}
+				}
+
+			return true;
+			}
+
+		case TYPE_VECTOR:
+			{
+			const auto& yield = t->AsVectorType()->Yield();
+			auto vv = v->AsVectorVal();
+
+			PackUInt(vv->Size());
+
+			for ( auto i = 0u; i < vv->Size(); ++i )
+				{
+				auto e = vv->ValAt(i);
+				PackUInt(e ? 1 : 0);
+
+				if ( e && ! Pack(e.get(), yield.get()) )
+					return false;
+				}
+
+			return true;
+			}
+
+		default:
+			// Includes any, for which the receiver couldn't tell the type.
+			return false;
+		}
+	}
+
+// Reads values written by ValPacker, never trusting the input.
+class ValUnpacker
+	{
+public:
+	ValUnpacker(const std::string& buf) : p(buf.data()), end(buf.data() + buf.size()) { }
+
+	ValPtr Unpack(Type* t);
+
+	bool AtEnd() const { return p == end; }
+
+private:
+	bool UnpackUInt(uint64_t* u)
+		{
+		*u = 0;
+
+		for ( int shift = 0; shift < 64; shift += 7 )
+			{
+			if ( p == end )
+				return false;
+
+			auto b = static_cast<uint8_t>(*p++);
+			*u |= static_cast<uint64_t>(b & 0x7f) << shift;
+
+			if ( ! (b & 0x80) )
+				return true;
+			}
+
+		return false;
+		}
+
+	bool UnpackInt(int64_t* i)
+		{
+		uint64_t u;
+
+		if ( ! UnpackUInt(&u) )
+			return false;
+
+		*i = static_cast<int64_t>((u >> 1) ^ (0 - (u & 1)));
+		return true;
+		}
+
+	// The number of elements of a container.  Each takes at least a
+	// byte, which bounds how many there can be.
+	bool UnpackCount(uint64_t* n)
+		{
+		return UnpackUInt(n) && *n <= static_cast<uint64_t>(end - p);
+		}
+
+	bool UnpackDouble(double* d)
+		{
+		if ( end - p < 8 )
+			return false;
+
+		uint64_t u = 0;
+
+		for ( int i = 7; i >= 0; --i )
+			u = (u << 8) | static_cast<uint8_t>(p[i]);
+
+		p += 8;
+		memcpy(d, &u, sizeof(u));
+		return true;
+		}
+
+	bool UnpackBytes(const char** data, size_t* len)
+		{
+		uint64_t n;
+
+		if ( ! UnpackCount(&n) )
+			return false;
+
+		*data = p;
+		*len = n;
+		p += n;
+		return true;
+		}
+
+	bool UnpackAddr(IPAddr* a)
+		{
+		in6_addr in6;
+
+		if ( end - p < static_cast<ptrdiff_t>(sizeof(in6)) )
+			return false;
+
+		memcpy(&in6, p, sizeof(in6));
+		p += sizeof(in6);
+		*a = IPAddr(in6);
+		return true;
+		}
+
+	const char* p;
+	const char* end;
+	};
+
+ValPtr ValUnpacker::Unpack(Type* t)
+	{
+	switch ( t->Tag() )
+		{
+		case TYPE_BOOL:
+		case TYPE_INT:
+			{
+			int64_t i;
+
+			if ( ! UnpackInt(&i) )
+				return nullptr;
+
+			if ( t->Tag() == TYPE_BOOL )
+				return val_mgr->Bool(i != 0);
+
+			return val_mgr->Int(i);
+			}
+
+		case TYPE_COUNT:
+		case TYPE_PORT:
+			{
+			uint64_t u;
+
+			if ( ! UnpackUInt(&u) )
+				return nullptr;
+
+			if ( t->Tag() == TYPE_COUNT )
+				return val_mgr->Count(u);
+
+			if ( u > UINT32_MAX )
+				return nullptr;
+
+			return val_mgr->Port(static_cast<uint32_t>(u));
+			}
+
+		case TYPE_DOUBLE:
+		case TYPE_TIME:
+		case TYPE_INTERVAL:
+			{
+			double d;
+
+			if ( ! UnpackDouble(&d) )
+				return nullptr;
+
+			if ( t->Tag() == TYPE_DOUBLE )
+				return val_mgr->Double(d);
+
+			if ( t->Tag() == TYPE_TIME )
+				return make_intrusive<TimeVal>(d);
+
+			return val_mgr->Interval(d);
+			}
+
+		case TYPE_ENUM:
+			{
+			const char* name;
+			size_t len;
+
+			if ( ! UnpackBytes(&name, &len) )
+				return nullptr;
+
+			auto et = t->AsEnumType();
+			auto i = et->Lookup(std::string(name, len));
+
+			if ( i == -1 )
+				return nullptr;
+
+			return et->GetEnumVal(i);
+			}
+
+		case TYPE_STRING:
+			{
+			const char* s;
+			size_t len;
+
+			if ( ! UnpackBytes(&s, &len) )
+				return nullptr;
+
+			return make_intrusive<StringVal>(static_cast<int>(len), s);
+			}
+
+		case TYPE_ADDR:
+			{
+			IPAddr a;
+
+			if ( ! UnpackAddr(&a) )
+				return nullptr;
+
+			return make_intrusive<AddrVal>(a);
+			}
+
+		case TYPE_SUBNET:
+			{
+			IPAddr a;
+			uint64_t len;
+
+			if ( ! UnpackAddr(&a) || ! UnpackUInt(&len) || len > 128 )
+				return nullptr;
+
+			return make_intrusive<SubNetVal>(IPPrefix(a, len, true));
+			}
+
+		case TYPE_RECORD:
+			{
+			auto rt = t->AsRecordType();
+			auto rv = make_intrusive<RecordVal>(IntrusivePtr{NewRef{}, rt});
+
+			for ( auto i = 0; i < rt->NumFields(); ++i )
+				{
+				uint64_t present;
+
+				if ( ! UnpackUInt(&present) )
+					return nullptr;
+
+				if ( ! present )
+					{
+					if ( rv->HasField(i) )
+						rv->Remove(i);
+
+					continue;
+					}
+
+				auto f = Unpack(rt->GetFieldType(i).get());
+
+				if ( ! f )
+					return nullptr;
+
+				rv->Assign(i, std::move(f));
+				}
+
+			return rv;
+			}
+
+		case TYPE_TABLE:
+			{
+			auto tt = t->AsTableType();
+			auto tv = make_intrusive<TableVal>(IntrusivePtr{NewRef{}, tt});
+			const auto& index_types = tt->GetIndexTypes();
+			uint64_t n;
+
+			if ( ! UnpackCount(&n) )
+				return nullptr;
+
+			for ( uint64_t i = 0; i < n; ++i )
+				{
+				auto idx = make_intrusive<ListVal>(TYPE_ANY);
+
+				for ( const auto& it : index_types )
+					{
+					auto iv = Unpack(it.get());
+
+					if ( ! iv )
+						return nullptr;
+
+					idx->Append(std::move(iv));
+					}
+
+				ValPtr yield;
+
+				if ( ! tt->IsSet() )
+					{
+					yield = Unpack(tt->Yield().get());
+
+					if ( ! yield )
+						return nullptr;
+					}
+
+				tv->Assign(std::move(idx), std::move(yield));
+				}
+
+			return tv;
+			}
+
+		case TYPE_VECTOR:
+			{
+			auto vt = t->AsVectorType();
+			auto vv = make_intrusive<VectorVal>(IntrusivePtr{NewRef{}, vt});
+			uint64_t n;
+
+			if ( ! UnpackCount(&n) )
+				return nullptr;
+
+			for ( uint64_t i = 0; i < n; ++i )
+				{
+				uint64_t present;
+
+				if ( ! UnpackUInt(&present) )
+					return nullptr;
+
+				if ( ! present )
+					continue;
+
+				auto e = Unpack(vt->Yield().get());
+
+				if ( ! e )
+					return nullptr;
+
+				vv->Assign(i, std::move(e));
+				}
+
+			if ( vv->Size() < n )
+				vv->Resize(n);
+
+			return vv;
+			}
+
+		default:
+			return nullptr;
+		}
+	}
+
+std::optional<std::string> pack_vals(const std::vector<TypePtr>& types, const zeek::Args& vals)
+	{
+	if ( types.size() != vals.size() )
+		return std::nullopt;
+
+	ValPacker packer;
+
+	for ( size_t i = 0; i < vals.size(); ++i )
+		if ( ! packer.Pack(vals[i].get(), types[i].get()) )
+			return std::nullopt;
+
+	return std::move(packer.Buffer());
+	}
+
+bool unpack_vals(const std::string& buf, const std::vector<TypePtr>& types, zeek::Args* vals)
+	{
+	ValUnpacker unpacker(buf);
+
+	for ( const auto& t : types )
+		{
+		auto v = unpacker.Unpack(t.get());
+
+		if ( ! v )
+			return false;
+
+		vals->emplace_back(std::move(v));
+		}
+
+	return unpacker.AtEnd();
+	}
+
+// Describes the layout of a type as far as the packed encoding depends on
+// it.  Records already being described show up as back references, so that
+// recursive types terminate.
+static void describe_packed_type(const Type* t, std::vector<const Type*>* records,
+                                 std::string* d)
+	{
+	*d += type_name(t->Tag());
+
+	switch ( t->Tag() )
+		{
+		case TYPE_RECORD:
+			{
+			auto it = std::find(records->begin(), records->end(), t);
+
+			if ( it != records->end() )
+				{
+				*d += '^' + std::to_string(it - records->begin());
+				break;
+				}
+
+			auto rt = t->AsRecordType();
+			records->push_back(t);
+			*d += '{';
+
+			for ( auto i = 0; i < rt->NumFields(); ++i )
+				{
+				*d += rt->FieldName(i);
+				*d += ':';
+				describe_packed_type(rt->GetFieldType(i).get(), records, d);
+				*d += ';';
+				}
+
+			*d += '}';
+			records->pop_back();
+			break;
+			}
+
+		case TYPE_TABLE:
+			{
+			auto tt = t->AsTableType();
+			*d += '[';
+
+			for ( const auto& index_type : tt->GetIndexTypes() )
+				{
+				describe_packed_type(index_type.get(), records, d);
+				*d += ',';
+				}
+
+			*d += ']';
+
+			if ( ! tt->IsSet() )
+				describe_packed_type(tt->Yield().get(), records, d);
+
+			break;
+			}
+
+		case TYPE_VECTOR:
+			*d += '[';
+			describe_packed_type(t->AsVectorType()->Yield().get(), records, d);
+			*d += ']';
+			break;
+
+		default:
+			break;
+		}
+	}
+
+// Returns the fingerprint sent along with packed arguments for events with
+// the given parameters.  The map keeps the type lists alive so that their
+// addresses remain unique.
+static broker::count packed_event_args_fingerprint(const TypeListPtr& params)
+	{
+	static std::unordered_map<const TypeList*, std::pair<TypeListPtr, broker::count>>
+		fingerprints;
+
+	auto it = fingerprints.find(params.get());
+
+	if ( it != fingerprints.end() )
+		return it->second.second;
+
+	std::string d;
+	std::vector<const Type*> records;
+
+	for ( const auto& t : params->GetTypes() )
+		{
+		describe_packed_type(t.get(), &records, &d);
+		d += ',';
+		}
+
+	// The static hash is the same across a cluster's nodes.
+	broker::count fp = zeek::detail::KeyedHash::StaticHash64(d.data(), d.size());
+	fingerprints.emplace(params.get(), std::make_pair(params, fp));
+
+	return fp;
+	}
+
+std::optional<broker::vector> pack_event_args(const TypeListPtr& params, const zeek::Args& args)
+	{
+	auto blob = pack_vals(params->GetTypes(), args);
+
+	if ( ! blob )
+		return std::nullopt;
+
+	return broker::vector{broker::enum_value{packed_event_args_marker},
+	                      static_cast<broker::count>(args.size()),
+	                      packed_event_args_fingerprint(params), std::move(*blob)};
+	}
+
+bool is_packed_event_args(const broker::vector& args)
+	{
+	if ( args.size() != 4 )
+		return false;
+
+	auto marker = get_if<broker::enum_value>(&args[0]);
+
+	return marker && marker->name == packed_event_args_marker &&
+	       get_if<broker::count>(&args[1]) && get_if<broker::count>(&args[2]) &&
+	       get_if<std::string>(&args[3]);
+	}
+
+bool unpack_event_args(const broker::vector& args, const TypeListPtr& params, zeek::Args* vl)
+	{
+	const auto& types = params->GetTypes();
+
+	if ( get<broker::count>(args[1]) != types.size() ||
+	     get<broker::count>(args[2]) != packed_event_args_fingerprint(params) )
+		return false;
+
+	return unpack_vals(get<std::string>(args[3]), types, vl);
+	}
+
 broker::data threading_field_to_data(const threading::Field* f)
 	{
 	auto name = f->name;
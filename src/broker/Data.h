@@ -1,9 +1,12 @@
 #pragma once
 
+#include <optional>
+
 #include "zeek/Expr.h"
 #include "zeek/Frame.h"
 #include "zeek/OpaqueVal.h"
 #include "zeek/Reporter.h"
+#include "zeek/ZeekArgs.h"
 
 #include "broker/data.hh"
 
@@ -73,6 +76,58 @@ broker::expected<broker::data> val_to_data(const Val* v);
  */
 ValPtr data_to_val(broker::data d, Type* type);
 
+/**
+ * Encode Zeek values into a single compact blob, the way pack_event_args()
+ * does.  The encoding omits type information.
+ * @param types the types of the values.
+ * @param vals the values.
+ * @return the encoded values, or nothing if their types don't allow for
+ * the encoding.
+ */
+std::optional<std::string> pack_vals(const std::vector<TypePtr>& types, const zeek::Args& vals);
+
+/**
+ * Decode values encoded by pack_vals().
+ * @param buf the encoded values.
+ * @param types the types of the values.
+ * @param vals the vector to add the decoded values to.
+ * @return true if successful, false if the encoding doesn't match the types.
+ */
+bool unpack_vals(const std::string& buf, const std::vector<TypePtr>& types, zeek::Args* vals);
+
+/**
+ * Encode event arguments directly from their Zeek values into a single
+ * compact blob, rather than into a tree of Broker data values with one
+ * heap-allocated node per value.  The encoding omits type information, so
+ * only receivers that know the event's signature can decode it.  It
+ * carries a fingerprint of the parameter types, though, so that receivers
+ * can tell if their signature differs.
+ * @param params the types of the event's parameters.
+ * @param args the event's arguments.
+ * @return the arguments to send in the event message, or nothing if the
+ * parameter types don't allow for the encoding (e.g., parameters of type
+ * any, or functions).
+ */
+std::optional<broker::vector> pack_event_args(const TypeListPtr& params, const zeek::Args& args);
+
+/**
+ * Check whether the arguments of an event message were made by
+ * pack_event_args().
+ * @param args the arguments of a received event message.
+ * @return true if the arguments need decoding via unpack_event_args().
+ */
+bool is_packed_event_args(const broker::vector& args);
+
+/**
+ * Decode the arguments of an event message made by pack_event_args().
+ * @param args the arguments of a received event message.
+ * @param params the types of the event's parameters.
+ * @param vl the vector to add the decoded arguments to.
+ * @return true if successful, false if the sender's parameter types differ
+ * or the arguments don't match the types.
+ */
+bool unpack_event_args(const broker::vector& args, const TypeListPtr& params, zeek::Args* vl);
+
 /**
  * Convert a zeek::threading::Field to a Broker data value.
  * @param f a zeek::threading::Field.
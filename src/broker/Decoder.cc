@@ -0,0 +1,263 @@
+#include "zeek/broker/Decoder.h"
+
+#include "zeek/SerializationFormat.h"
+#include "zeek/threading/SerialTypes.h"
+
+namespace zeek::Broker::detail
+	{
+
+DecodedLogWrite::~DecodedLogWrite()
+	{
+	for ( auto vals : rows )
+		threading::Value::delete_value_ptr_array(vals, num_fields);
+	}
+
+// Reads the rows following the header of a batch packed by
+// Manager::LogBuffer::AddPackedRow().
+static bool decode_packed_rows(zeek::detail::SerializationFormat* fmt, size_t len,
+                               DecodedLogWrite* d)
+	{
+	int num_fields;
+
+	// Rows without fields wouldn't consume any input.
+	if ( ! fmt->Read(&num_fields, "num_fields") || num_fields <= 0 ||
+	     num_fields > static_cast<int>(fmt->BytesLeft()) )
+		return false;
+
+	std::vector<std::pair<TypeTag, TypeTag>> types;
+	types.reserve(num_fields);
+
+	for ( int i = 0; i < num_fields; ++i )
+		{
+		int type;
+		int subtype;
+
+		if ( ! (fmt->Read(&type, "type") && fmt->Read(&subtype, "subtype")) )
+			return false;
+
+		types.emplace_back(static_cast<TypeTag>(type), static_cast<TypeTag>(subtype));
+		}
+
+	d->num_fields = num_fields;
+
+	while ( static_cast<size_t>(fmt->BytesRead()) < len )
+		{
+		auto vals = new threading::Value*[num_fields];
+
+		for ( int i = 0; i < num_fields; ++i )
+			{
+			vals[i] = new threading::Value;
+
+			if ( ! vals[i]->ReadUntyped(fmt, types[i].first, types[i].second) )
+				{
+				threading::Value::delete_value_ptr_array(vals, i + 1);
+				return false;
+				}
+			}
+
+		d->rows.push_back(vals);
+		}
+
+	return true;
+	}
+
+std::unique_ptr<DecodedLogWrite> decode_log_write(broker::zeek::LogWrite lw)
+	{
+	auto d = std::make_unique<DecodedLogWrite>();
+
+	if ( ! lw.valid() )
+		{
+		d->error = "received invalid broker LogWrite: " + broker::to_string(lw.as_data());
+		return d;
+		}
+
+	d->stream_id = lw.stream_id().name;
+	d->writer_id = lw.writer_id().name;
+
+	auto path = broker::get_if<std::string>(&lw.path());
+
+	if ( ! path )
+		{
+		d->error = "failed to unpack remote log values (bad path variant) for stream: " +
+		           d->stream_id;
+		return d;
+		}
+
+	d->path = std::move(*path);
+
+	auto serial_data = broker::get_if<std::string>(&lw.serial_data());
+
+	if ( ! serial_data )
+		{
+		d->error = "failed to unpack remote log values (bad serial_data variant) for stream: " +
+		           d->stream_id;
+		return d;
+		}
+
+	zeek::detail::BinarySerializationFormat fmt;
+	fmt.SetQuiet();
+	fmt.StartRead(serial_data->data(), serial_data->size());
+
+	// Adds what the format ran into, if anything, to the result.
+	auto finish = [&fmt, &d](std::string error)
+	{
+		if ( ! error.empty() && ! fmt.ReadError().empty() )
+			error += " (" + fmt.ReadError() + ")";
+
+		if ( ! error.empty() )
+			d->error = std::move(error);
+		else
+			d->warning = fmt.ReadError();
+
+		fmt.EndRead();
+		return std::move(d);
+	};
+
+	int num_fields;
+
+	// Each field takes at least a few bytes, which also keeps a bogus
+	// count from allocating excessively.
+	if ( ! fmt.Read(&num_fields, "num_fields") || num_fields < packed_log_rows_marker ||
+	     num_fields > static_cast<int>(fmt.BytesLeft()) )
+		return finish("failed to unserialize remote log num fields for stream: " + d->stream_id);
+
+	if ( num_fields == packed_log_rows_marker )
+		{
+		if ( ! decode_packed_rows(&fmt, serial_data->size(), d.get()) )
+			return finish("failed to unserialize packed remote log rows for stream: " +
+			              d->stream_id);
+
+		return finish("");
+		}
+
+	auto vals = new threading::Value*[num_fields];
+
+	for ( int i = 0; i < num_fields; ++i )
+		{
+		vals[i] = new threading::Value;
+
+		if ( ! vals[i]->Read(&fmt) )
+			{
+			threading::Value::delete_value_ptr_array(vals, i + 1);
+			return finish("failed to unserialize remote log field " + std::to_string(i) +
+			              " for stream: " + d->stream_id);
+			}
+		}
+
+	d->num_fields = num_fields;
+	d->rows.push_back(vals);
+	return finish("");
+	}
+
+DecoderPool::DecoderPool(int num_threads)
+	{
+	for ( int i = 0; i < num_threads; ++i )
+		workers.emplace_back(&DecoderPool::Worker, this);
+	}
+
+DecoderPool::~DecoderPool()
+	{
+		{
+		std::lock_guard<std::mutex> lock(mtx);
+		terminating = true;
+		todo.clear();
+		}
+
+	has_work.notify_all();
+
+	for ( auto& t : workers )
+		t.join();
+	}
+
+bool DecoderPool::WantsMessage(const broker::data_message& msg)
+	{
+	const auto& topic = broker::get_topic(msg);
+
+	if ( broker::is_prefix(topic, broker::topic::statuses_str) ||
+	     broker::is_prefix(topic, broker::topic::errors_str) ||
+	     broker::is_prefix(topic, broker::topic::store_events_str) )
+		return false;
+
+	auto type = broker::zeek::Message::type(broker::get_data(msg));
+
+	return type == broker::zeek::Message::Type::LogWrite ||
+	       type == broker::zeek::Message::Type::Batch;
+	}
+
+std::shared_ptr<DecodeJob> DecoderPool::Submit(broker::data_message msg)
+	{
+	auto job = std::make_shared<DecodeJob>();
+	job->msg = std::move(msg);
+
+		{
+		std::lock_guard<std::mutex> lock(mtx);
+		todo.push_back(job);
+		}
+
+	has_work.notify_one();
+	return job;
+	}
+
+void DecoderPool::Wait(const std::shared_ptr<DecodeJob>& job)
+	{
+	std::unique_lock<std::mutex> lock(mtx);
+	has_result.wait(lock, [&job] { return job->done; });
+	}
+
+void DecoderPool::Worker()
+	{
+	std::unique_lock<std::mutex> lock(mtx);
+
+	while ( true )
+		{
+		has_work.wait(lock, [this] { return terminating || ! todo.empty(); });
+
+		if ( terminating )
+			return;
+
+		auto job = std::move(todo.front());
+		todo.pop_front();
+
+		lock.unlock();
+		Decode(job.get());
+		lock.lock();
+
+		job->done = true;
+		has_result.notify_all();
+		}
+	}
+
+void DecoderPool::Decode(DecodeJob* job)
+	{
+	// Copying the data keeps the message itself untouched, as the main
+	// thread still accesses it.
+	auto data = broker::get_data(job->msg);
+
+	auto add_item = [job](broker::data d)
+	{
+		if ( broker::zeek::Message::type(d) == broker::zeek::Message::Type::LogWrite )
+			job->items.push_back({decode_log_write(std::move(d)), broker::data{}});
+		else
+			job->items.push_back({nullptr, std::move(d)});
+	};
+
+	if ( broker::zeek::Message::type(data) != broker::zeek::Message::Type::Batch )
+		{
+		add_item(std::move(data));
+		return;
+		}
+
+	broker::zeek::Batch batch(std::move(data));
+
+	if ( ! batch.valid() )
+		{
+		// Leave reporting this to the main thread.
+		job->items.push_back({nullptr, batch.move_data()});
+		return;
+		}
+
+	for ( auto& i : batch.batch() )
+		add_item(std::move(i));
+	}
+
+	} // namespace zeek::Broker::detail
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <broker/data.hh>
+#include <broker/message.hh>
+#include <broker/zeek.hh>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace zeek
+	{
+
+namespace threading
+	{
+struct Value;
+	}
+
+namespace Broker::detail
+	{
+
+// Starts the serialized data of LogWrite messages that carry a batch of
+// rows packed by Manager::LogBuffer::AddPackedRow(), in place of the
+// number of fields of an individual row.
+constexpr int packed_log_rows_marker = -1;
+
+/**
+ * A LogWrite message decoded into threading values.
+ */
+struct DecodedLogWrite
+	{
+	~DecodedLogWrite();
+
+	std::string stream_id;
+	std::string writer_id;
+	std::string path;
+	int num_fields = 0;
+
+	// Arrays of num_fields values each, one per row.  Owned until
+	// handed off to the logging manager.
+	std::vector<threading::Value**> rows;
+
+	// Describes what's wrong with the message if it is malformed.
+	std::string error;
+
+	// Describes a problem with the message that decoding worked around,
+	// such as a string containing NULs.
+	std::string warning;
+	};
+
+/**
+ * Decodes a LogWrite message.  This doesn't touch any Zeek values or
+ * global state, and leaves reporting problems to the caller, so it is
+ * safe to call from any thread.
+ * @param lw the message.
+ * @return the decoded rows, with the error field set on failure.
+ */
+std::unique_ptr<DecodedLogWrite> decode_log_write(broker::zeek::LogWrite lw);
+
+/**
+ * A message polled from Broker, with any log writes it contains decoded.
+ */
+struct DecodeJob
+	{
+	// One part of the message: either a decoded log write, or anything
+	// else, left for the main thread to process.
+	struct Item
+		{
+		std::unique_ptr<DecodedLogWrite> log_write;
+		broker::data other;
+		};
+
+	broker::data_message msg;
+	std::vector<Item> items;
+	bool done = false;
+	};
+
+/**
+ * A pool of threads decoding the log writes in incoming Broker messages,
+ * individually or in batches, in parallel to the main thread.  Zeek values
+ * can only be created on the main thread, so events and all other messages
+ * are passed through as they are.
+ *
+ * Jobs are handed back in the order they were submitted, which keeps
+ * messages in the order Broker delivered them.  Apart from its worker
+ * threads, a pool must only be used from a single thread.
+ */
+class DecoderPool
+	{
+public:
+	/**
+	 * Constructor.
+	 * @param num_threads the number of decoding threads to start.
+	 */
+	explicit DecoderPool(int num_threads);
+
+	/**
+	 * Destructor.  Stops the threads, discarding any pending jobs.
+	 */
+	~DecoderPool();
+
+	/**
+	 * Returns true if a message contains log writes, and thus is worth
+	 * submitting.
+	 */
+	static bool WantsMessage(const broker::data_message& msg);
+
+	/**
+	 * Queues a message for decoding.  It remains shared with the caller,
+	 * who needs to keep it unmodified until the job is done.
+	 */
+	std::shared_ptr<DecodeJob> Submit(broker::data_message msg);
+
+	/**
+	 * Waits for a job to finish.
+	 */
+	void Wait(const std::shared_ptr<DecodeJob>& job);
+
+private:
+	void Worker();
+	static void Decode(DecodeJob* job);
+
+	std::vector<std::thread> workers;
+	std::deque<std::shared_ptr<DecodeJob>> todo;
+	std::mutex mtx;
+	std::condition_variable has_work;
+	std::condition_variable has_result;
+	bool terminating = false;
+	};
+
+	} // namespace Broker::detail
+	} // namespace zeek
@@ -14,9 +14,12 @@
 #include "zeek/Reporter.h"
 #include "zeek/RunState.h"
 #include "zeek/SerializationFormat.h"
+#include "zeek/Timer.h"
 #include "zeek/Var.h"
 #include "zeek/broker/Data.h"
+#include "zeek/broker/Decoder.h"
 #include "zeek/broker/Store.h"
+#include "zeek/broker/TableSnapshot.h"
 #include "zeek/broker/comm.bif.h"
 #include "zeek/broker/data.bif.h"
 #include "zeek/broker/messaging.bif.h"
@@ -261,6 +264,17 @@ void Manager::InitPostScript()
 	zeek_table_manager = get_option("Broker::table_store_master")->AsBool();
 	zeek_table_db_directory =
 		get_option("Broker::table_store_db_directory")->AsString()->CheckString();
+	table_snapshot_directory =
+		get_option("Broker::table_store_snapshot_directory")->AsString()->CheckString();
+	table_snapshot_reconcile_delay =
+		get_option("Broker::table_store_snapshot_reconcile_delay")->AsInterval();
+	pack_event_args = get_option("Broker::pack_event_args")->AsBool();
+	pack_log_writes = get_option("Broker::pack_log_writes")->AsBool();
+
+	auto decoder_threads = get_option("Broker::decoder_threads")->AsCount();
+
+	if ( decoder_threads > 0 )
+		decoder_pool = std::make_unique<detail::DecoderPool>(decoder_threads);
 
 	detail::opaque_of_data_type = make_intrusive<OpaqueType>("Broker::Data");
 	detail::opaque_of_set_iterator = make_intrusive<OpaqueType>("Broker::SetIterator");
@@ -401,6 +415,23 @@ void Manager::InitPostScript()
 			}
 		}
 
+	WITH_OPT_MAPPING("broker.metrics.import.topics", "Broker::metrics_import_topics")
+		{
+		if ( auto topics = opt.broker_read<std::vector<std::string>>() )
+			{
+			opt.zeek_write(*topics);
+			}
+		else
+			{
+			auto ptr = opt.zeek_read()->AsVectorVal();
+			std::vector<std::string> topics;
+			for ( unsigned index = 0; index < ptr->Size(); ++index )
+				topics.emplace_back(ptr->StringValAt(index)->ToStdString());
+			if ( ! topics.empty() )
+				opt.broker_write(std::move(topics));
+			}
+		}
+
 	auto cqs = get_option("Broker::congestion_queue_size")->AsCount();
 	bstate = std::make_shared<BrokerState>(std::move(config), cqs);
 
@@ -460,9 +491,12 @@ void Manager::InitializeBrokerStoreForwarding()
 void Manager::Terminate()
 	{
 	FlushLogBuffers();
+	decoder_pool.reset();
 
 	iosource_mgr->UnregisterFd(bstate->subscriber.fd(), this);
 
+	WriteTableSnapshots();
+
 	vector<string> stores_to_close;
 
 	for ( auto& x : data_stores )
@@ -758,61 +792,76 @@ bool Manager::PublishLogWrite(EnumVal* stream, EnumVal* writer, string path, int
 		return false;
 		}
 
-	zeek::detail::BinarySerializationFormat fmt;
-	char* data;
-	int len;
-
-	fmt.StartWrite();
-
-	bool success = fmt.Write(num_fields, "num_fields");
+	auto v = log_topic_func->Invoke(IntrusivePtr{NewRef{}, stream},
+	                                make_intrusive<StringVal>(path));
 
-	if ( ! success )
+	if ( ! v )
 		{
-		reporter->Error("Failed to remotely log stream %s: num_fields serialization failed",
-		                stream_id);
+		reporter->Error("Failed to remotely log: log_topic func did not return"
+		                " a value for stream %s at path %s",
+		                stream_id, path.data());
 		return false;
 		}
 
-	for ( int i = 0; i < num_fields; ++i )
+	std::string topic = v->AsString()->CheckString();
+
+	if ( log_buffers.size() <= (unsigned int)stream_id_num )
+		log_buffers.resize(stream_id_num + 1);
+
+	auto& lb = log_buffers[stream_id_num];
+
+	if ( pack_log_writes )
 		{
-		if ( ! vals[i]->Write(&fmt) )
+		if ( ! lb.AddPackedRow(topic, stream_id, writer_id, path, num_fields, vals) )
 			{
-			reporter->Error("Failed to remotely log stream %s: field %d serialization failed",
-			                stream_id, i);
+			reporter->Error("Failed to remotely log stream %s: fields don't match earlier writes",
+			                stream_id);
 			return false;
 			}
 		}
+	else
+		{
+		zeek::detail::BinarySerializationFormat fmt;
+		char* data;
+		int len;
 
-	len = fmt.EndWrite(&data);
-	std::string serial_data(data, len);
-	free(data);
+		fmt.StartWrite();
 
-	auto v = log_topic_func->Invoke(IntrusivePtr{NewRef{}, stream},
-	                                make_intrusive<StringVal>(path));
+		bool success = fmt.Write(num_fields, "num_fields");
 
-	if ( ! v )
-		{
-		reporter->Error("Failed to remotely log: log_topic func did not return"
-		                " a value for stream %s at path %s",
-		                stream_id, path.data());
-		return false;
-		}
+		if ( ! success )
+			{
+			reporter->Error("Failed to remotely log stream %s: num_fields serialization failed",
+			                stream_id);
+			return false;
+			}
 
-	std::string topic = v->AsString()->CheckString();
+		for ( int i = 0; i < num_fields; ++i )
+			{
+			if ( ! vals[i]->Write(&fmt) )
+				{
+				reporter->Error("Failed to remotely log stream %s: field %d serialization failed",
+				                stream_id, i);
+				return false;
+				}
+			}
 
-	auto bstream_id = broker::enum_value(move(stream_id));
-	auto bwriter_id = broker::enum_value(move(writer_id));
-	broker::zeek::LogWrite msg(move(bstream_id), move(bwriter_id), move(path), move(serial_data));
+		len = fmt.EndWrite(&data);
+		std::string serial_data(data, len);
+		free(data);
 
-	DBG_LOG(DBG_BROKER, "Buffering log record: %s", RenderMessage(topic, msg.as_data()).c_str());
+		auto bstream_id = broker::enum_value(move(stream_id));
+		auto bwriter_id = broker::enum_value(move(writer_id));
+		broker::zeek::LogWrite msg(move(bstream_id), move(bwriter_id), move(path),
+		                           move(serial_data));
 
-	if ( log_buffers.size() <= (unsigned int)stream_id_num )
-		log_buffers.resize(stream_id_num + 1);
+		DBG_LOG(DBG_BROKER, "Buffering log record: %s",
+		        RenderMessage(topic, msg.as_data()).c_str());
+
+		lb.msgs[topic].emplace_back(msg.move_data());
+		}
 
-	auto& lb = log_buffers[stream_id_num];
 	++lb.message_count;
-	auto& pending_batch = lb.msgs[topic];
-	pending_batch.emplace_back(msg.move_data());
 
 	if ( lb.message_count >= log_batch_size )
 		statistics.num_logs_outgoing += lb.Flush(bstate->endpoint, log_batch_size);
@@ -820,6 +869,47 @@ bool Manager::PublishLogWrite(EnumVal* stream, EnumVal* writer, string path, int
 	return true;
 	}
 
+bool Manager::LogBuffer::AddPackedRow(const std::string& topic, const char* stream_id,
+                                      const char* writer_id, const std::string& path,
+                                      int num_fields, const threading::Value* const* vals)
+	{
+	auto& rows = packed_rows[topic + '\0' + writer_id + '\0' + path];
+
+	if ( ! rows.fmt )
+		{
+		// First row for this topic and path, start with the header
+		// describing the fields.
+		rows.topic = topic;
+		rows.stream_id = stream_id;
+		rows.writer_id = writer_id;
+		rows.path = path;
+		rows.fmt = std::make_unique<zeek::detail::BinarySerializationFormat>();
+		rows.fmt->StartWrite();
+		rows.fmt->Write(detail::packed_log_rows_marker, "marker");
+		rows.fmt->Write(num_fields, "num_fields");
+
+		for ( int i = 0; i < num_fields; ++i )
+			{
+			rows.types.push_back(vals[i]->type);
+			rows.fmt->Write(static_cast<int>(vals[i]->type), "type");
+			rows.fmt->Write(static_cast<int>(vals[i]->subtype), "subtype");
+			}
+		}
+
+	if ( rows.types.size() != static_cast<size_t>(num_fields) )
+		return false;
+
+	for ( int i = 0; i < num_fields; ++i )
+		if ( vals[i]->type != rows.types[i] )
+			return false;
+
+	for ( int i = 0; i < num_fields; ++i )
+		if ( ! vals[i]->WriteUntyped(rows.fmt.get()) )
+			return false;
+
+	return true;
+	}
+
 size_t Manager::LogBuffer::Flush(broker::endpoint& endpoint, size_t log_batch_size)
 	{
 	if ( endpoint.is_shutdown() )
@@ -829,6 +919,22 @@ size_t Manager::LogBuffer::Flush(broker::endpoint& endpoint, size_t log_batch_si
 		// No logs buffered for this stream.
 		return 0;
 
+	for ( auto& kv : packed_rows )
+		{
+		auto& rows = kv.second;
+		char* data;
+		auto len = rows.fmt->EndWrite(&data);
+		std::string serial_data(data, len);
+		free(data);
+
+		broker::zeek::LogWrite msg(broker::enum_value(move(rows.stream_id)),
+		                           broker::enum_value(move(rows.writer_id)), move(rows.path),
+		                           move(serial_data));
+		msgs[rows.topic].emplace_back(msg.move_data());
+		}
+
+	packed_rows.clear();
+
 	for ( auto& kv : msgs )
 		{
 		auto& topic = kv.first;
@@ -1096,6 +1202,17 @@ void Manager::DispatchMessage(const broker::topic& topic, broker::data msg)
 		}
 	}
 
+void Manager::DispatchDecoded(const broker::topic& topic, detail::DecodeJob* job)
+	{
+	for ( auto& item : job->items )
+		{
+		if ( item.log_write )
+			ProcessDecodedLogWrite(item.log_write.get());
+		else
+			DispatchMessage(topic, std::move(item.other));
+		}
+	}
+
 void Manager::Process()
 	{
 	// Ensure that time gets update before processing broker messages, or events
@@ -1107,8 +1224,22 @@ void Manager::Process()
 
 	bool had_input = ! messages.empty();
 
-	for ( auto& message : messages )
+	// Have the decoder threads start on all log writes right away, so
+	// that they're ready by the time we get to them below.
+	std::vector<std::shared_ptr<detail::DecodeJob>> jobs;
+
+	if ( decoder_pool )
 		{
+		jobs.resize(messages.size());
+
+		for ( size_t i = 0; i < messages.size(); ++i )
+			if ( detail::DecoderPool::WantsMessage(messages[i]) )
+				jobs[i] = decoder_pool->Submit(messages[i]);
+		}
+
+	for ( size_t i = 0; i < messages.size(); ++i )
+		{
+		auto& message = messages[i];
 		auto& topic = broker::get_topic(message);
 
 		if ( broker::is_prefix(topic, broker::topic::statuses_str) )
@@ -1147,6 +1278,13 @@ void Manager::Process()
 
 		try
 			{
+			if ( ! jobs.empty() && jobs[i] )
+				{
+				decoder_pool->Wait(jobs[i]);
+				DispatchDecoded(topic, jobs[i].get());
+				continue;
+				}
+
 			// Once we call a broker::move_* function, we force Broker to
 			// unshare the content of the message, i.e., copy the content to a
 			// different memory region if other threads keep references to the
@@ -1257,6 +1395,8 @@ void Manager::ProcessStoreEvent(broker::data msg)
 		if ( ! storehandle )
 			return;
 
+		storehandle->ForgetCached(insert.key());
+
 		const auto& table = storehandle->forward_to;
 		if ( ! table )
 			return;
@@ -1265,6 +1405,10 @@ void Manager::ProcessStoreEvent(broker::data msg)
 		if ( insert.publisher() == storehandle->store_pid )
 			return;
 
+		const auto& value = insert.value();
+		if ( ConfirmSnapshotEntry(insert.store_id(), storehandle, insert.key(), &value) )
+			return;
+
 		ProcessStoreEventInsertUpdate(table, insert.store_id(), insert.key(), insert.value(), {},
 		                              true);
 		}
@@ -1274,6 +1418,8 @@ void Manager::ProcessStoreEvent(broker::data msg)
 		if ( ! storehandle )
 			return;
 
+		storehandle->ForgetCached(update.key());
+
 		const auto& table = storehandle->forward_to;
 		if ( ! table )
 			return;
@@ -1282,6 +1428,10 @@ void Manager::ProcessStoreEvent(broker::data msg)
 		if ( update.publisher() == storehandle->store_pid )
 			return;
 
+		const auto& value = update.new_value();
+		if ( ConfirmSnapshotEntry(update.store_id(), storehandle, update.key(), &value) )
+			return;
+
 		ProcessStoreEventInsertUpdate(table, update.store_id(), update.key(), update.new_value(),
 		                              update.old_value(), false);
 		}
@@ -1291,6 +1441,8 @@ void Manager::ProcessStoreEvent(broker::data msg)
 		if ( ! storehandle )
 			return;
 
+		storehandle->ForgetCached(erase.key());
+
 		auto table = storehandle->forward_to;
 		if ( ! table )
 			return;
@@ -1299,6 +1451,8 @@ void Manager::ProcessStoreEvent(broker::data msg)
 		if ( erase.publisher() == storehandle->store_pid )
 			return;
 
+		ConfirmSnapshotEntry(erase.store_id(), storehandle, erase.key(), nullptr);
+
 		auto key = erase.key();
 		DBG_LOG(DBG_BROKER, "Store %s: Erase key %s", erase.store_id().c_str(),
 		        to_string(key).c_str());
@@ -1318,14 +1472,17 @@ void Manager::ProcessStoreEvent(broker::data msg)
 		}
 	else if ( auto expire = broker::store_event::expire::make(msg) )
 		{
-			// We just ignore expiries - expiring information on the Zeek side is handled by Zeek
-			// itself.
-#ifdef DEBUG
-		// let's only debug log for stores that we know.
-		auto storehandle = broker_mgr->LookupStore(expire.store_id());
+			auto storehandle = broker_mgr->LookupStore(expire.store_id());
 		if ( ! storehandle )
 			return;
 
+		storehandle->ForgetCached(expire.key());
+
+		// Otherwise we just ignore expiries - expiring information on the Zeek side is handled
+		// by Zeek itself.
+#ifdef DEBUG
+		// let's only debug log for stores that we know.
+
 		auto table = storehandle->forward_to;
 		if ( ! table )
 			return;
@@ -1374,7 +1531,23 @@ void Manager::ProcessEvent(const broker::topic& topic, broker::zeek::Event ev)
 		return;
 		}
 
-	const auto& arg_types = handler->GetType(false)->ParamList()->GetTypes();
+	const auto& params = handler->GetType(false)->ParamList();
+	const auto& arg_types = params->GetTypes();
+
+	if ( detail::is_packed_event_args(args) )
+		{
+		Args vl;
+		vl.reserve(arg_types.size());
+
+		if ( detail::unpack_event_args(args, params, &vl) )
+			event_mgr.Enqueue(handler, std::move(vl), util::detail::SOURCE_BROKER);
+		else
+			reporter->Warning("failed to decode packed arguments of remote event '%s'"
+			                  " (its parameter types may differ from the sender's)",
+			                  name.data());
+
+		return;
+		}
 
 	if ( arg_types.size() != args.size() )
 		{
@@ -1506,89 +1679,48 @@ bool Manager::ProcessLogCreate(broker::zeek::LogCreate lc)
 bool Manager::ProcessLogWrite(broker::zeek::LogWrite lw)
 	{
 	DBG_LOG(DBG_BROKER, "Received log-write: %s", RenderMessage(lw.as_data()).c_str());
+	auto d = detail::decode_log_write(std::move(lw));
+	return ProcessDecodedLogWrite(d.get());
+	}
 
-	if ( ! lw.valid() )
+bool Manager::ProcessDecodedLogWrite(detail::DecodedLogWrite* d)
+	{
+	if ( ! d->error.empty() )
 		{
-		reporter->Warning("received invalid broker LogWrite: %s",
-		                  broker::to_string(lw.as_data()).data());
+		reporter->Warning("%s", d->error.c_str());
 		return false;
 		}
 
-	++statistics.num_logs_incoming;
-	auto& stream_id_name = lw.stream_id().name;
+	if ( ! d->warning.empty() )
+		reporter->Warning("remote log write for stream %s: %s", d->stream_id.c_str(),
+		                  d->warning.c_str());
+
+	statistics.num_logs_incoming += d->rows.size();
 
 	// Get stream ID.
-	auto stream_id = detail::data_to_val(std::move(lw.stream_id()), log_id_type);
+	auto stream_id = detail::data_to_val(broker::enum_value{d->stream_id}, log_id_type);
 
 	if ( ! stream_id )
 		{
-		reporter->Warning("failed to unpack remote log stream id: %s", stream_id_name.data());
+		reporter->Warning("failed to unpack remote log stream id: %s", d->stream_id.data());
 		return false;
 		}
 
 	// Get writer ID.
-	auto writer_id = detail::data_to_val(std::move(lw.writer_id()), writer_id_type);
+	auto writer_id = detail::data_to_val(broker::enum_value{d->writer_id}, writer_id_type);
 	if ( ! writer_id )
 		{
 		reporter->Warning("failed to unpack remote log writer id for stream: %s",
-		                  stream_id_name.data());
+		                  d->stream_id.data());
 		return false;
 		}
 
-	auto path = get_if<std::string>(&lw.path());
+	for ( auto vals : d->rows )
+		log_mgr->WriteFromRemote(stream_id->AsEnumVal(), writer_id->AsEnumVal(), d->path,
+		                         d->num_fields, vals);
 
-	if ( ! path )
-		{
-		reporter->Warning("failed to unpack remote log values (bad path variant) for stream: %s",
-		                  stream_id_name.data());
-		return false;
-		}
-
-	auto serial_data = get_if<std::string>(&lw.serial_data());
-
-	if ( ! serial_data )
-		{
-		reporter->Warning(
-			"failed to unpack remote log values (bad serial_data variant) for stream: %s",
-			stream_id_name.data());
-		return false;
-		}
-
-	zeek::detail::BinarySerializationFormat fmt;
-	fmt.StartRead(serial_data->data(), serial_data->size());
-
-	int num_fields;
-	bool success = fmt.Read(&num_fields, "num_fields");
-
-	if ( ! success )
-		{
-		reporter->Warning("failed to unserialize remote log num fields for stream: %s",
-		                  stream_id_name.data());
-		return false;
-		}
-
-	auto vals = new threading::Value*[num_fields];
-
-	for ( int i = 0; i < num_fields; ++i )
-		{
-		vals[i] = new threading::Value;
-
-		if ( ! vals[i]->Read(&fmt) )
-			{
-			for ( int j = 0; j <= i; ++j )
-				delete vals[j];
-
-			delete[] vals;
-			reporter->Warning("failed to unserialize remote log field %d for stream: %s", i,
-			                  stream_id_name.data());
-
-			return false;
-			}
-		}
-
-	log_mgr->WriteFromRemote(stream_id->AsEnumVal(), writer_id->AsEnumVal(), std::move(*path),
-	                         num_fields, vals);
-	fmt.EndRead();
+	// The logging manager took ownership.
+	d->rows.clear();
 	return true;
 	}
 
@@ -1744,6 +1876,16 @@ void Manager::ProcessStoreResponse(detail::StoreHandleVal* s, broker::store::res
 	{
 	DBG_LOG(DBG_BROKER, "Received store response: %s", RenderMessage(response).c_str());
 
+	auto internal = internal_queries.find(std::make_pair(response.id, s));
+
+	if ( internal != internal_queries.end() )
+		{
+		auto cb = std::move(internal->second);
+		internal_queries.erase(internal);
+		cb(std::move(response.answer));
+		return;
+		}
+
 	auto request = pending_queries.find(std::make_pair(response.id, s));
 
 	if ( request == pending_queries.end() )
@@ -1914,6 +2056,158 @@ void Manager::BrokerStoreToZeekTable(const std::string& name, const detail::Stor
 	return;
 	}
 
+// Where the snapshot of the table backing a clone goes.
+static std::string table_snapshot_file(const std::string& dir, const std::string& name)
+	{
+	return dir + "/" + name + ".snapshot";
+	}
+
+void Manager::LoadTableSnapshot(const std::string& name, const detail::StoreHandleVal* handle)
+	{
+	if ( table_snapshot_directory.empty() || ! handle->forward_to )
+		return;
+
+	auto file = table_snapshot_file(table_snapshot_directory, name);
+
+	if ( ! util::is_file(file) )
+		return;
+
+	std::string error;
+	auto snapshot = detail::TableSnapshot::Load(file, handle->forward_to, &error);
+
+	if ( ! snapshot )
+		{
+		reporter->Warning("ignoring snapshot %s of Broker store %s: %s", file.c_str(),
+		                  name.c_str(), error.c_str());
+		return;
+		}
+
+	DBG_LOG(DBG_BROKER, "Loaded %zu entries of store %s from snapshot", snapshot->Size(),
+	        name.c_str());
+	table_snapshots[name] = std::move(snapshot);
+
+	// In case the clone never reports a change, such as when the master
+	// is empty.
+	ScheduleTableSnapshotReconcile(name);
+	}
+
+void Manager::WriteTableSnapshots()
+	{
+	if ( table_snapshot_directory.empty() )
+		return;
+
+	for ( const auto& [name, handle] : data_stores )
+		{
+		if ( ! handle->is_clone || ! handle->forward_to )
+			continue;
+
+		auto file = table_snapshot_file(table_snapshot_directory, name);
+		std::string error;
+
+		if ( ! detail::TableSnapshot::Write(file, handle->forward_to.get(), &error) )
+			reporter->Warning("could not write snapshot %s of Broker store %s: %s", file.c_str(),
+			                  name.c_str(), error.c_str());
+		}
+	}
+
+bool Manager::ConfirmSnapshotEntry(const std::string& name, detail::StoreHandleVal* handle,
+                                   const broker::data& key, const broker::data* value)
+	{
+	auto s = table_snapshots.find(name);
+	if ( s == table_snapshots.end() )
+		return false;
+
+	auto& snapshot = s->second;
+
+	// This may be the first change the clone reports as part of its
+	// initial synchronization.  The clone applies the master's content in
+	// one go before reporting it, so its keys are complete by now.
+	ReconcileTableSnapshot(name);
+
+	auto unchanged = snapshot->Confirm(key, value);
+
+	if ( snapshot->Done() )
+		table_snapshots.erase(s);
+
+	return unchanged;
+	}
+
+class TableSnapshotReconcileTimer final : public zeek::detail::Timer
+	{
+public:
+	TableSnapshotReconcileTimer(double t, std::string name)
+		: zeek::detail::Timer(t, zeek::detail::TIMER_BROKER_SNAPSHOT_RECONCILE),
+		  store_name(std::move(name))
+		{
+		}
+
+	void Dispatch(double t, bool is_expire) override
+		{
+		if ( ! is_expire )
+			broker_mgr->ReconcileTableSnapshot(store_name);
+		}
+
+private:
+	std::string store_name;
+	};
+
+void Manager::ScheduleTableSnapshotReconcile(const std::string& name)
+	{
+	zeek::detail::timer_mgr->Add(new TableSnapshotReconcileTimer(
+		run_state::network_time + table_snapshot_reconcile_delay, name));
+	}
+
+void Manager::ReconcileTableSnapshot(const std::string& name)
+	{
+	auto s = table_snapshots.find(name);
+	if ( s == table_snapshots.end() || s->second->Reconciled() || s->second->ReconcilePending() )
+		return;
+
+	auto handle = LookupStore(name);
+	if ( ! handle )
+		return;
+
+	// Without any peers, there's no master the clone could have
+	// synchronized with.
+	if ( Peers().empty() )
+		{
+		ScheduleTableSnapshotReconcile(name);
+		return;
+		}
+
+	s->second->SetReconcilePending(true);
+
+	auto cb = [this, name](broker::expected<broker::data> keys)
+		{
+		auto s = table_snapshots.find(name);
+		if ( s == table_snapshots.end() )
+			return;
+
+		auto& snapshot = s->second;
+		snapshot->SetReconcilePending(false);
+
+		auto set = keys ? get_if<broker::set>(&(keys->get_data())) : nullptr;
+		auto handle = LookupStore(name);
+
+		if ( ! set || ! handle )
+			{
+			DBG_LOG(DBG_BROKER, "Could not get keys of store %s to reconcile its snapshot",
+			        name.c_str());
+			ScheduleTableSnapshotReconcile(name);
+			return;
+			}
+
+		auto removed = snapshot->Reconcile(*set, handle->forward_to.get());
+		DBG_LOG(DBG_BROKER, "Removed %zu entries of store %s that are gone from the master",
+		        removed, name.c_str());
+
+		if ( snapshot->Done() )
+			table_snapshots.erase(s);
+		};
+
+	TrackInternalStoreQuery(handle, handle->proxy.keys(), std::move(cb));
+	}
+
 detail::StoreHandleVal* Manager::MakeClone(const string& name, double resync_interval,
                                            double stale_interval, double mutation_buffer_interval)
 	{
@@ -1934,6 +2228,7 @@ detail::StoreHandleVal* Manager::MakeClone(const string& name, double resync_int
 		}
 
 	auto handle = new detail::StoreHandleVal{*result};
+	handle->is_clone = true;
 	Ref(handle);
 
 	data_stores.emplace(name, handle);
@@ -1941,6 +2236,7 @@ detail::StoreHandleVal* Manager::MakeClone(const string& name, double resync_int
 		reporter->FatalError(
 			"Failed to register broker clone mailbox descriptor with iosource_mgr");
 	PrepareForwarding(name);
+	LoadTableSnapshot(name, handle);
 	return handle;
 	}
 
@@ -1972,6 +2268,23 @@ bool Manager::CloseStore(const string& name)
 			++i;
 			}
 
+	table_snapshots.erase(name);
+
+	// Let whatever waits for Zeek's own queries know that they failed.
+	std::vector<InternalQueryCallback> aborted;
+
+	for ( auto i = internal_queries.begin(); i != internal_queries.end(); )
+		if ( i->first.second == s->second )
+			{
+			aborted.emplace_back(std::move(i->second));
+			i = internal_queries.erase(i);
+			}
+		else
+			++i;
+
+	for ( auto& cb : aborted )
+		cb(broker::ec::unspecified);
+
 	s->second->have_store = false;
 	s->second->store_pid = {};
 	s->second->proxy = {};
@@ -1993,6 +2306,12 @@ bool Manager::TrackStoreQuery(detail::StoreHandleVal* handle, broker::request_id
 	return rval;
 	}
 
+void Manager::TrackInternalStoreQuery(detail::StoreHandleVal* handle, broker::request_id id,
+                                      InternalQueryCallback cb)
+	{
+	internal_queries.emplace(std::make_pair(id, handle), std::move(cb));
+	}
+
 const Stats& Manager::GetStatistics()
 	{
 	statistics.num_peers = peer_count;
@@ -13,11 +13,13 @@
 #include <broker/store.hh>
 #include <broker/topic.hh>
 #include <broker/zeek.hh>
+#include <functional>
 #include <memory>
 #include <string>
 #include <unordered_map>
 
 #include "zeek/IntrusivePtr.h"
+#include "zeek/SerializationFormat.h"
 #include "zeek/iosource/IOSource.h"
 #include "zeek/logging/WriterBackend.h"
 
@@ -47,6 +49,10 @@ namespace detail
 	{
 class StoreHandleVal;
 class StoreQueryCallback;
+struct DecodedLogWrite;
+struct DecodeJob;
+class DecoderPool;
+class TableSnapshot;
 	};
 
 class BrokerState;
@@ -185,6 +191,13 @@ public:
 	 */
 	bool PublishEvent(std::string topic, RecordVal* ev);
 
+	/**
+	 * @return true if events published via scripts should have their
+	 * arguments encoded with detail::pack_event_args() when possible, as
+	 * configured by Broker::pack_event_args.
+	 */
+	bool PackingEventArgs() const { return pack_event_args; }
+
 	/**
 	 * Send a message to create a log stream to any interested peers.
 	 * The log stream may or may not already exist on the receiving side.
@@ -340,6 +353,25 @@ public:
 	bool TrackStoreQuery(detail::StoreHandleVal* handle, broker::request_id id,
 	                     detail::StoreQueryCallback* cb);
 
+	using InternalQueryCallback = std::function<void(broker::expected<broker::data>)>;
+
+	/**
+	 * Register a callback for a data store query issued by Zeek itself
+	 * rather than by a script.
+	 * @param cb called with the store's answer, or with an error if the
+	 * store gets closed first.
+	 */
+	void TrackInternalStoreQuery(detail::StoreHandleVal* handle, broker::request_id id,
+	                             InternalQueryCallback cb);
+
+	/**
+	 * Reconciles the snapshot that a clone's table was filled from with
+	 * the keys the clone has, unless that has happened already.  If the
+	 * clone can't tell yet, tries again later.
+	 * @param name the store's name.
+	 */
+	void ReconcileTableSnapshot(const std::string& name);
+
 	/**
 	 * Send all pending log write messages.
 	 * @return the number of messages sent.
@@ -407,6 +439,11 @@ private:
 	void ProcessEvent(const broker::topic& topic, broker::zeek::Event ev);
 	bool ProcessLogCreate(broker::zeek::LogCreate lc);
 	bool ProcessLogWrite(broker::zeek::LogWrite lw);
+	// Passes log rows decoded via detail::decode_log_write() on to the
+	// logging manager.
+	bool ProcessDecodedLogWrite(detail::DecodedLogWrite* d);
+	// Processes a message whose log writes a decoder thread took care of.
+	void DispatchDecoded(const broker::topic& topic, detail::DecodeJob* job);
 	bool ProcessIdentifierUpdate(broker::zeek::IdentifierUpdate iu);
 	void ProcessStatus(broker::status_view stat);
 	void ProcessError(broker::error_view err);
@@ -419,6 +456,17 @@ private:
 	// Send the content of a Broker store to the backing table. This is typically used
 	// when a master/clone is created.
 	void BrokerStoreToZeekTable(const std::string& name, const detail::StoreHandleVal* handle);
+	// Fills the table backing a clone from its snapshot file, if there is one.
+	void LoadTableSnapshot(const std::string& name, const detail::StoreHandleVal* handle);
+	// Writes snapshot files for the tables backing clones.
+	void WriteTableSnapshots();
+	// Checks a change reported by a clone against the table's snapshot, if
+	// one is still pending.  Returns true if the table already reflects it.
+	bool ConfirmSnapshotEntry(const std::string& name, detail::StoreHandleVal* handle,
+	                          const broker::data& key, const broker::data* value);
+	// Arranges for ReconcileTableSnapshot() to run after
+	// Broker::table_store_snapshot_reconcile_delay.
+	void ScheduleTableSnapshotReconcile(const std::string& name);
 
 	void Error(const char* format, ...) __attribute__((format(printf, 2, 3)));
 
@@ -427,15 +475,37 @@ private:
 	const char* Tag() override { return "Broker::Manager"; }
 	double GetNextTimeout() override { return -1; }
 
+	// Log rows for one topic, writer and path, packed into a single
+	// LogWrite message once flushed.  The message's data starts with the
+	// types of the fields, followed by the rows' values without them.
+	struct PackedLogRows
+		{
+		std::string topic;
+		std::string stream_id;
+		std::string writer_id;
+		std::string path;
+		std::vector<TypeTag> types;
+		std::unique_ptr<zeek::detail::BinarySerializationFormat> fmt;
+		};
+
 	struct LogBuffer
 		{
 		// Indexed by topic string.
 		std::unordered_map<std::string, broker::vector> msgs;
+		// Indexed by topic, writer and path.
+		std::unordered_map<std::string, PackedLogRows> packed_rows;
 		size_t message_count;
 
+		// Adds a row to pack.  Returns false if its fields don't match
+		// those of earlier rows for the same topic, writer and path.
+		bool AddPackedRow(const std::string& topic, const char* stream_id,
+		                  const char* writer_id, const std::string& path, int num_fields,
+		                  const threading::Value* const* vals);
+
 		size_t Flush(broker::endpoint& endpoint, size_t batch_size);
 		};
 
+
 	// Data stores
 	using query_id = std::pair<broker::request_id, detail::StoreHandleVal*>;
 
@@ -455,7 +525,11 @@ private:
 	std::shared_ptr<BrokerState> bstate;
 	std::unordered_map<std::string, detail::StoreHandleVal*> data_stores;
 	std::unordered_map<std::string, TableValPtr> forwarded_stores;
+	// Snapshots loaded into forwarded tables, until their clone has
+	// confirmed all entries.
+	std::unordered_map<std::string, std::unique_ptr<detail::TableSnapshot>> table_snapshots;
 	std::unordered_map<query_id, detail::StoreQueryCallback*, query_id_hasher> pending_queries;
+	std::unordered_map<query_id, InternalQueryCallback, query_id_hasher> internal_queries;
 	std::vector<std::string> forwarded_prefixes;
 
 	Stats statistics;
@@ -471,6 +545,11 @@ private:
 	EnumType* writer_id_type;
 	bool zeek_table_manager = false;
 	std::string zeek_table_db_directory;
+	std::string table_snapshot_directory;
+	double table_snapshot_reconcile_delay = 0.0;
+	bool pack_event_args = false;
+	bool pack_log_writes = false;
+	std::unique_ptr<detail::DecoderPool> decoder_pool;
 
 	static int script_scope;
 	};
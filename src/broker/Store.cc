@@ -2,7 +2,10 @@
 
 #include "zeek/Desc.h"
 #include "zeek/ID.h"
+#include "zeek/broker/Data.h"
 #include "zeek/broker/Manager.h"
+#include "zeek/telemetry/Manager.h"
+#include "zeek/util.h"
 
 zeek::OpaqueTypePtr zeek::Broker::detail::opaque_of_store_handle;
 
@@ -26,6 +29,85 @@ EnumValPtr query_status(bool success)
 	return rval;
 	}
 
+static telemetry::IntCounter cache_lookups(const std::string& store_name, const char* result)
+	{
+	auto family = telemetry_mgr->CounterFamily(
+		"zeek", "broker-store-cache-lookups", {"store", "result"},
+		"Lookups answered by (hit) or passed on from (miss) Broker store read caches", "1", true);
+	return family.GetOrAdd({{"store", store_name}, {"result", result}});
+	}
+
+StoreReadCache::StoreReadCache(const std::string& store_name, double arg_ttl,
+                               size_t arg_max_entries)
+	: ttl(arg_ttl), max_entries(arg_max_entries), hits(cache_lookups(store_name, "hit")),
+	  misses(cache_lookups(store_name, "miss"))
+	{
+	}
+
+bool StoreReadCache::Lookup(const broker::data& key, std::optional<broker::data>* val)
+	{
+	auto e = entries.find(key);
+
+	if ( e == entries.end() || e->second.expires <= util::current_time(true) )
+		{
+		misses.Inc();
+		return false;
+		}
+
+	hits.Inc();
+	*val = e->second.val;
+	return true;
+	}
+
+void StoreReadCache::Insert(const broker::data& key, std::optional<broker::data> val)
+	{
+	if ( max_entries == 0 )
+		return;
+
+	auto now = util::current_time(true);
+
+	while ( ! order.empty() && (order.front().second <= now || order.size() >= max_entries) )
+		PopOldest();
+
+	auto expires = now + ttl;
+	entries[key] = Entry{std::move(val), expires};
+	order.emplace_back(key, expires);
+	}
+
+void StoreReadCache::Forget(const broker::data& key)
+	{
+	entries.erase(key);
+	}
+
+void StoreReadCache::Clear()
+	{
+	entries.clear();
+	order.clear();
+	}
+
+void StoreReadCache::PopOldest()
+	{
+	const auto& [key, expires] = order.front();
+	auto e = entries.find(key);
+
+	if ( e != entries.end() && e->second.expires == expires )
+		entries.erase(e);
+
+	order.pop_front();
+	}
+
+void StoreHandleVal::CacheAnswer(const broker::data& key,
+                                 const broker::expected<broker::data>& answer)
+	{
+	if ( ! read_cache )
+		return;
+
+	if ( answer )
+		read_cache->Insert(key, *answer);
+	else if ( answer.error() == broker::ec::no_such_key )
+		read_cache->Insert(key, std::nullopt);
+	}
+
 void StoreHandleVal::ValDescribe(ODesc* d) const
 	{
 	d->Add("broker::store::");
@@ -50,6 +132,65 @@ bool StoreHandleVal::DoUnserialize(const broker::data& data)
 	return false;
 	}
 
+StoreCachedQuery::StoreCachedQuery(zeek::detail::trigger::Trigger* arg_trigger,
+                                   const zeek::detail::CallExpr* arg_call, StoreHandleVal* arg_handle,
+                                   bool arg_many, broker::table arg_found)
+	: trigger(arg_trigger), call(arg_call), handle{NewRef{}, arg_handle}, many(arg_many),
+	  found(std::move(arg_found))
+	{
+	Ref(trigger);
+	}
+
+void StoreCachedQuery::Send(std::shared_ptr<StoreCachedQuery> query, const broker::vector& keys)
+	{
+	auto handle = query->handle.get();
+	query->pending = keys.size();
+
+	for ( const auto& key : keys )
+		{
+		auto cb = [query, key](broker::expected<broker::data> answer)
+			{
+			query->Answer(key, std::move(answer));
+			};
+
+		broker_mgr->TrackInternalStoreQuery(handle, handle->proxy.get(key), std::move(cb));
+		}
+	}
+
+void StoreCachedQuery::Answer(const broker::data& key, broker::expected<broker::data> answer)
+	{
+	handle->CacheAnswer(key, answer);
+
+	if ( answer )
+		found.emplace(key, std::move(*answer));
+
+	else if ( answer.error() == broker::ec::request_timeout ||
+	          answer.error() == broker::ec::stale_data )
+		// Like for Broker::get(), the trigger's timeout takes care of
+		// these.
+		timed_out = true;
+
+	else if ( answer.error() != broker::ec::no_such_key )
+		failed = true;
+
+	if ( --pending > 0 || timed_out || trigger->Disabled() )
+		return;
+
+	RecordValPtr result;
+
+	if ( failed )
+		result = query_result();
+	else if ( many )
+		result = query_result(make_data_val(std::move(found)));
+	else if ( found.empty() )
+		result = query_result();
+	else
+		result = query_result(make_data_val(std::move(found.begin()->second)));
+
+	trigger->Cache(call, result.get());
+	trigger->Release();
+	}
+
 broker::backend to_backend_type(BifEnum::Broker::BackendType type)
 	{
 	switch ( type )
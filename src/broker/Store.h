@@ -4,11 +4,16 @@
 #include <broker/backend_options.hh>
 #include <broker/store.hh>
 #include <broker/store_event.hh>
+#include <deque>
+#include <map>
+#include <memory>
+#include <optional>
 
 #include "zeek/OpaqueVal.h"
 #include "zeek/Trigger.h"
 #include "zeek/broker/data.bif.h"
 #include "zeek/broker/store.bif.h"
+#include "zeek/telemetry/Counter.h"
 
 namespace zeek::Broker::detail
 	{
@@ -104,6 +109,77 @@ private:
 	broker::store store;
 	};
 
+/**
+ * A local cache of the values looked up in a data store, answering repeated
+ * lookups of the same key without a request to the store.  Keys found not
+ * to exist are cached as well.  Entries are dropped once their time to live
+ * passes, when the store reports a change to them, and oldest first when
+ * the cache fills up.
+ */
+class StoreReadCache
+	{
+public:
+	/**
+	 * Constructor.
+	 * @param store_name the name of the store, for labeling its metrics.
+	 * @param ttl how long entries remain valid, in seconds.
+	 * @param max_entries the maximum number of entries to keep.
+	 */
+	StoreReadCache(const std::string& store_name, double ttl, size_t max_entries);
+
+	/**
+	 * Looks up a key.
+	 * @param key the key to look up.
+	 * @param val set to the cached value on a hit, or left unset if the
+	 * key is known not to exist.
+	 * @return true on a hit, false if the store needs to be asked.
+	 */
+	bool Lookup(const broker::data& key, std::optional<broker::data>* val);
+
+	/**
+	 * Caches the store's answer for a key.
+	 * @param key the key.
+	 * @param val its value, or unset if it doesn't exist.
+	 */
+	void Insert(const broker::data& key, std::optional<broker::data> val);
+
+	/**
+	 * Drops a key from the cache.
+	 */
+	void Forget(const broker::data& key);
+
+	/**
+	 * Drops all keys from the cache.
+	 */
+	void Clear();
+
+	size_t Size() const { return entries.size(); }
+
+private:
+	struct Entry
+		{
+		std::optional<broker::data> val;
+		double expires;
+		};
+
+	// Drops the entry at the front of the insertion order, if it's
+	// still current.
+	void PopOldest();
+
+	double ttl;
+	size_t max_entries;
+	std::map<broker::data, Entry> entries;
+
+	// Keys with their expiration times, in the order they were inserted,
+	// which given the fixed TTL is also the order in which they expire.
+	// Elements whose keys were forgotten or inserted again since are left
+	// in place and skipped once they reach the front.
+	std::deque<std::pair<broker::data, double>> order;
+
+	telemetry::IntCounter hits;
+	telemetry::IntCounter misses;
+	};
+
 /**
  * An opaque handle which wraps a Broker data store.
  */
@@ -120,12 +196,43 @@ public:
 
 	void ValDescribe(ODesc* d) const override;
 
+	/**
+	 * Looks up a key in the read cache, if there is one, without asking
+	 * the store.
+	 * @param key the key to look up.
+	 * @param val set to the cached value on a hit, or left unset if the
+	 * key is known not to exist.
+	 * @return true on a hit, false if the store needs to be asked.
+	 */
+	bool LookupCached(const broker::data& key, std::optional<broker::data>* val)
+		{
+		return read_cache && read_cache->Lookup(key, val);
+		}
+
+	/**
+	 * Caches the store's answer to a lookup of a key, if there's a read
+	 * cache.  Errors other than the key not existing aren't cached.
+	 */
+	void CacheAnswer(const broker::data& key, const broker::expected<broker::data>& answer);
+
+	/**
+	 * Drops a key from the read cache, if there is one, after it changed.
+	 */
+	void ForgetCached(const broker::data& key)
+		{
+		if ( read_cache )
+			read_cache->Forget(key);
+		}
+
 	broker::store store;
 	broker::store::proxy proxy;
 	broker::publisher_id store_pid;
 	// Zeek table that events are forwarded to.
 	TableValPtr forward_to;
 	bool have_store = false;
+	bool is_clone = false;
+	// Set if lookups through this handle are cached.
+	std::unique_ptr<StoreReadCache> read_cache;
 
 protected:
 	IntrusivePtr<Val> DoClone(CloneState* state) override { return {NewRef{}, this}; }
@@ -133,6 +240,46 @@ protected:
 	DECLARE_OPAQUE_VALUE(StoreHandleVal)
 	};
 
+/**
+ * Used for lookups through a store handle's read cache that need to ask the
+ * store about some of the keys.  Sends an asynchronous query for each of
+ * them, caches the answers, and passes the overall result to the "when"
+ * statement waiting for it once all are in.
+ */
+class StoreCachedQuery
+	{
+public:
+	/**
+	 * Constructor.
+	 * @param many whether the result is a table of the keys found, as for
+	 * Broker::get_many(), rather than the value of a single key.
+	 * @param found the keys already answered from the cache, with their
+	 * values.
+	 */
+	StoreCachedQuery(zeek::detail::trigger::Trigger* trigger, const zeek::detail::CallExpr* call,
+	                 StoreHandleVal* handle, bool many, broker::table found);
+
+	~StoreCachedQuery() { Unref(trigger); }
+
+	/**
+	 * Sends the queries for the given keys.  The query object lives until
+	 * the last of them is answered or the store is closed.
+	 */
+	static void Send(std::shared_ptr<StoreCachedQuery> query, const broker::vector& keys);
+
+private:
+	void Answer(const broker::data& key, broker::expected<broker::data> answer);
+
+	zeek::detail::trigger::Trigger* trigger;
+	const zeek::detail::CallExpr* call;
+	IntrusivePtr<StoreHandleVal> handle;
+	bool many;
+	broker::table found;
+	size_t pending = 0;
+	bool failed = false;
+	bool timed_out = false;
+	};
+
 // Helper function to construct a broker backend type from script land.
 broker::backend to_backend_type(BifEnum::Broker::BackendType type);
 
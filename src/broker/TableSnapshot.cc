@@ -0,0 +1,242 @@
+#include "zeek/broker/TableSnapshot.h"
+
+#include <unistd.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "zeek/Desc.h"
+#include "zeek/Hash.h"
+#include "zeek/SerializationFormat.h"
+#include "zeek/broker/Data.h"
+#include "zeek/util.h"
+
+namespace zeek::Broker::detail
+	{
+
+static constexpr uint32_t TABLE_SNAPSHOT_VERSION = 1;
+static constexpr const char* TABLE_SNAPSHOT_MAGIC = "Zeek-table-snapshot";
+
+uint64_t data_digest(const broker::data& d)
+	{
+	auto s = to_string(d);
+	return zeek::detail::KeyedHash::StaticHash64(s.data(), s.size());
+	}
+
+// A description of a table's type, for making sure a snapshot is only
+// loaded into a table of the same type.
+static std::string describe_type(const TableVal* table)
+	{
+	ODesc d;
+	table->GetType()->Describe(&d);
+	return d.Description();
+	}
+
+// The types of the values encoded for each entry: those of its index,
+// followed by its yield for tables.
+static std::vector<TypePtr> entry_types(const TableType* tt)
+	{
+	auto types = tt->GetIndexTypes();
+
+	if ( ! tt->IsSet() )
+		types.emplace_back(tt->Yield());
+
+	return types;
+	}
+
+bool TableSnapshot::Write(const std::string& file_name, const TableVal* table, std::string* error)
+	{
+	auto tt = table->GetType()->AsTableType();
+	auto types = entry_types(tt);
+
+	zeek::detail::BinarySerializationFormat fmt;
+	fmt.StartWrite();
+
+	fmt.Write(TABLE_SNAPSHOT_MAGIC, "magic");
+	fmt.Write(TABLE_SNAPSHOT_VERSION, "version");
+	fmt.Write(describe_type(table), "type");
+	fmt.Write(static_cast<uint64_t>(table->Size()), "num-entries");
+
+	for ( const auto& te : *table->Get() )
+		{
+		auto index = table->RecreateIndex(*te.GetHashKey());
+		auto vals = index->Vals();
+
+		// Broker keys use the index directly if it has a single element,
+		// and a vector of its elements otherwise.
+		auto key = vals.size() == 1 ? val_to_data(vals[0].get()) : val_to_data(index.get());
+		broker::expected<broker::data> value = broker::data{};
+
+		if ( ! tt->IsSet() )
+			{
+			vals.emplace_back(te.GetValue<TableEntryVal*>()->GetVal());
+			value = val_to_data(vals.back().get());
+			}
+
+		auto blob = pack_vals(types, vals);
+
+		if ( ! key || ! value || ! blob )
+			{
+			*error = "table type not supported";
+			char* data;
+			fmt.EndWrite(&data);
+			free(data);
+			return false;
+			}
+
+		fmt.Write(data_digest(*key), "key-digest");
+		fmt.Write(data_digest(*value), "value-digest");
+		fmt.Write(*blob, "entry");
+		}
+
+	char* data;
+	auto len = fmt.EndWrite(&data);
+
+	auto tmp_name = util::fmt("%s.%d.tmp", file_name.c_str(), getpid());
+	std::string tmp{tmp_name};
+
+	std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+	out.write(data, len);
+	out.close();
+	free(data);
+
+	if ( ! out || rename(tmp.c_str(), file_name.c_str()) < 0 )
+		{
+		*error = strerror(errno);
+		unlink(tmp.c_str());
+		return false;
+		}
+
+	return true;
+	}
+
+std::unique_ptr<TableSnapshot> TableSnapshot::Load(const std::string& file_name,
+                                                   const TableValPtr& table, std::string* error)
+	{
+	std::ifstream in(file_name, std::ios::binary);
+	if ( ! in )
+		{
+		*error = strerror(errno);
+		return nullptr;
+		}
+
+	std::stringstream ss;
+	ss << in.rdbuf();
+	auto data = ss.str();
+
+	// A damaged file shouldn't take down the process.
+	zeek::detail::BinarySerializationFormat fmt;
+	fmt.SetQuiet();
+	fmt.StartRead(data.data(), data.size());
+
+	std::string magic;
+	uint32_t version;
+	std::string type;
+	uint64_t n;
+
+	if ( ! fmt.Read(&magic, "magic") || magic != TABLE_SNAPSHOT_MAGIC ||
+	     ! fmt.Read(&version, "version") || version != TABLE_SNAPSHOT_VERSION ||
+	     ! fmt.Read(&type, "type") || ! fmt.Read(&n, "num-entries") )
+		{
+		*error = "not a snapshot file";
+		return nullptr;
+		}
+
+	if ( type != describe_type(table.get()) )
+		{
+		*error = "snapshot was written for a different table type";
+		return nullptr;
+		}
+
+	auto tt = table->GetType()->AsTableType();
+	auto types = entry_types(tt);
+	auto num_index_vals = tt->GetIndexTypes().size();
+	auto rval = std::make_unique<TableSnapshot>();
+
+	// Decode the whole file before touching the table, so that a corrupt
+	// entry doesn't leave it partially filled.
+	std::vector<std::pair<ListValPtr, ValPtr>> decoded;
+
+	for ( uint64_t i = 0; i < n; ++i )
+		{
+		uint64_t key_digest;
+		uint64_t value_digest;
+		std::string blob;
+		zeek::Args vals;
+
+		if ( ! fmt.Read(&key_digest, "key-digest") || ! fmt.Read(&value_digest, "value-digest") ||
+		     ! fmt.Read(&blob, "entry") || ! unpack_vals(blob, types, &vals) )
+			{
+			*error = "truncated or corrupt snapshot file";
+			return nullptr;
+			}
+
+		auto index = make_intrusive<ListVal>(TYPE_ANY);
+
+		for ( size_t j = 0; j < num_index_vals; ++j )
+			index->Append(std::move(vals[j]));
+
+		rval->entries[key_digest] = Entry{value_digest, index};
+		decoded.emplace_back(std::move(index), tt->IsSet() ? nullptr : std::move(vals.back()));
+		}
+
+	fmt.EndRead();
+
+	// Like when filling the table from the store, don't raise &on_change
+	// notifications: as far as scripts are concerned, the entries have
+	// been there all along.
+	table->DisableChangeNotifications();
+
+	for ( auto& [index, value] : decoded )
+		table->Assign(std::move(index), std::move(value), false);
+
+	table->EnableChangeNotifications();
+
+	return rval;
+	}
+
+bool TableSnapshot::Confirm(const broker::data& key, const broker::data* value)
+	{
+	auto e = entries.find(data_digest(key));
+
+	if ( e == entries.end() )
+		return false;
+
+	auto unchanged = value && e->second.value_digest == data_digest(*value);
+	entries.erase(e);
+	return unchanged;
+	}
+
+size_t TableSnapshot::Reconcile(const broker::set& keys, TableVal* table)
+	{
+	std::unordered_set<uint64_t> present;
+	present.reserve(keys.size());
+
+	for ( const auto& k : keys )
+		present.insert(data_digest(k));
+
+	size_t removed = 0;
+
+	for ( auto e = entries.begin(); e != entries.end(); )
+		{
+		if ( present.count(e->first) )
+			{
+			++e;
+			continue;
+			}
+
+		table->Remove(*e->second.index, false);
+		e = entries.erase(e);
+		++removed;
+		}
+
+	reconciled = true;
+	return removed;
+	}
+
+	} // namespace zeek::Broker::detail
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <broker/data.hh>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "zeek/Val.h"
+
+namespace zeek::Broker::detail
+	{
+
+/**
+ * Computes a digest of a Broker data value that remains the same across
+ * runs, as long as :zeek:see:`digest_salt` doesn't change.
+ */
+uint64_t data_digest(const broker::data& d);
+
+/**
+ * A snapshot of a table backed by a Broker store clone, letting a restarted
+ * node fill the table from a local file rather than from the master.
+ *
+ * Besides the table's entries, a snapshot file holds a digest of each
+ * entry's key and value as the store has them.  Once loaded, a snapshot
+ * tracks which of its entries the clone has yet to confirm: when the
+ * clone's initial synchronization with the master reports an entry whose
+ * digests match, the table already holds it and the conversion from
+ * Broker data can be skipped.  Entries that the master no longer has are
+ * removed by Reconcile(), once the clone's keys are known.
+ */
+class TableSnapshot
+	{
+public:
+	/**
+	 * Writes the contents of a table to a snapshot file.  The file is
+	 * replaced atomically.
+	 * @param file_name the name of the file.
+	 * @param table the table.
+	 * @param error set to a description of what went wrong on failure.
+	 * @return true if successful.
+	 */
+	static bool Write(const std::string& file_name, const TableVal* table, std::string* error);
+
+	/**
+	 * Fills a table from a snapshot file.
+	 * @param file_name the name of the file.
+	 * @param table the table, whose type must match the one the snapshot
+	 * was written for.
+	 * @param error set to a description of what went wrong on failure.
+	 * @return the loaded snapshot, or nil on failure.
+	 */
+	static std::unique_ptr<TableSnapshot> Load(const std::string& file_name,
+	                                           const TableValPtr& table, std::string* error);
+
+	/**
+	 * Marks an entry reported by the store as seen.
+	 * @param key the entry's key.
+	 * @param value the entry's value, or nil if the store erased it.
+	 * @return true if the table already holds the entry as loaded from the
+	 * snapshot and doesn't need to be updated.
+	 */
+	bool Confirm(const broker::data& key, const broker::data* value);
+
+	/**
+	 * Removes all entries from the table that the store doesn't have.
+	 * @param keys the keys the store has.
+	 * @param table the table the snapshot was loaded into.
+	 * @return the number of entries removed.
+	 */
+	size_t Reconcile(const broker::set& keys, TableVal* table);
+
+	/**
+	 * Returns true once Reconcile() has been called.
+	 */
+	bool Reconciled() const { return reconciled; }
+
+	/**
+	 * Returns true while the keys to reconcile the snapshot with have
+	 * been requested from the store, but haven't arrived yet.
+	 */
+	bool ReconcilePending() const { return reconcile_pending; }
+
+	void SetReconcilePending(bool pending) { reconcile_pending = pending; }
+
+	/**
+	 * Returns true if no entries remain to be confirmed.
+	 */
+	bool Done() const { return reconciled && entries.empty(); }
+
+	size_t Size() const { return entries.size(); }
+
+private:
+	struct Entry
+		{
+		uint64_t value_digest;
+		ListValPtr index;
+		};
+
+	// Indexed by the digest of the entry's key.
+	std::unordered_map<uint64_t, Entry> entries;
+	bool reconciled = false;
+	bool reconcile_pending = false;
+	};
+
+	} // namespace zeek::Broker::detail
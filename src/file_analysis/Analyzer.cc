@@ -2,6 +2,7 @@
 
 #include "zeek/file_analysis/Analyzer.h"
 
+#include "zeek/Stats.h"
 #include "zeek/Val.h"
 #include "zeek/file_analysis/Manager.h"
 
@@ -13,6 +14,9 @@ ID Analyzer::id_counter = 0;
 Analyzer::~Analyzer()
 	{
 	DBG_LOG(DBG_FILE_ANALYSIS, "Destroy file analyzer %s", file_mgr->GetComponentName(tag).c_str());
+
+	if ( cost_metrics )
+		cost_metrics->instances.Dec();
 	}
 
 void Analyzer::SetAnalyzerTag(const zeek::Tag& arg_tag)
@@ -33,4 +37,16 @@ Analyzer::Analyzer(RecordValPtr arg_args, File* arg_file)
 	{
 	}
 
+zeek::detail::AnalyzerMetrics* Analyzer::CostMetrics()
+	{
+	if ( ! cost_metrics )
+		{
+		auto name = file_mgr->GetComponentName(tag);
+		cost_metrics = zeek::detail::analyzer_cost_profiler->Metrics("file", name.c_str());
+		cost_metrics->instances.Inc();
+		}
+
+	return cost_metrics;
+	}
+
 	} // namespace zeek::file_analysis
@@ -12,6 +12,11 @@ namespace zeek
 class RecordVal;
 using RecordValPtr = IntrusivePtr<RecordVal>;
 
+namespace detail
+	{
+struct AnalyzerMetrics;
+	}
+
 namespace file_analysis
 	{
 
@@ -133,6 +138,13 @@ public:
 	 */
 	bool Skipping() const { return skip; }
 
+	/**
+	 * Returns the telemetry kept for the analyzer's type when
+	 * :zeek:see:`analyzer_cost_sample_rate` is set.  Must only be called
+	 * when that's the case.
+	 */
+	zeek::detail::AnalyzerMetrics* CostMetrics();
+
 protected:
 	/**
 	 * Constructor.  Only derived classes are meant to be instantiated.
@@ -161,6 +173,7 @@ private:
 	File* file; /**< The file to which the analyzer is attached. */
 	bool got_stream_delivery;
 	bool skip;
+	zeek::detail::AnalyzerMetrics* cost_metrics = nullptr;
 
 	static ID id_counter;
 	};
@@ -7,6 +7,7 @@
 #include "zeek/Event.h"
 #include "zeek/Reporter.h"
 #include "zeek/RuleMatcher.h"
+#include "zeek/Stats.h"
 #include "zeek/Type.h"
 #include "zeek/Val.h"
 #include "zeek/analyzer/Analyzer.h"
@@ -20,6 +21,37 @@
 namespace zeek::file_analysis
 	{
 
+// Accounts a delivery to a file analyzer with the AnalyzerCostProfiler
+// across its lifetime, if there is one.
+class DeliveryCost
+	{
+public:
+	DeliveryCost(Analyzer* arg_analyzer, uint64_t len)
+		{
+		if ( ! zeek::detail::analyzer_cost_profiler )
+			return;
+
+		analyzer = arg_analyzer;
+		analyzer->CostMetrics()->bytes.Inc(len);
+		start = zeek::detail::analyzer_cost_profiler->Begin();
+		}
+
+	~DeliveryCost()
+		{
+		if ( ! analyzer )
+			return;
+
+		auto cpu_time = zeek::detail::analyzer_cost_profiler->End(start);
+
+		if ( cpu_time > 0 )
+			analyzer->CostMetrics()->cpu_time.Inc(cpu_time);
+		}
+
+private:
+	Analyzer* analyzer = nullptr;
+	uint64_t start = 0;
+	};
+
 static TableValPtr empty_connection_table()
 	{
 	auto tbl_index = make_intrusive<TypeList>(id::conn_id);
@@ -399,6 +431,8 @@ void File::DeliverStream(const u_char* data, uint64_t len)
 				{
 				if ( ! a->Skipping() )
 					{
+					DeliveryCost cost(a, bof_buffer.chunks[i]->Len());
+
 					if ( ! a->DeliverStream(bof_buffer.chunks[i]->Bytes(),
 					                        bof_buffer.chunks[i]->Len()) )
 						{
@@ -417,6 +451,8 @@ void File::DeliverStream(const u_char* data, uint64_t len)
 
 		if ( ! a->Skipping() )
 			{
+			DeliveryCost cost(a, len);
+
 			if ( ! a->DeliverStream(data, len) )
 				{
 				a->SetSkip(true);
@@ -481,6 +517,8 @@ void File::DeliverChunk(const u_char* data, uint64_t len, uint64_t offset)
 		        file_mgr->GetComponentName(a->Tag()).c_str());
 		if ( ! a->Skipping() )
 			{
+			DeliveryCost cost(a, len);
+
 			if ( ! a->DeliverChunk(data, len, offset) )
 				{
 				a->SetSkip(true);
@@ -316,6 +316,9 @@ File* Manager::GetFile(const string& file_id, Connection* conn, const zeek::Tag&
 
 	if ( ! rval )
 		{
+		if ( ignore_new_files )
+			return nullptr;
+
 		rval = new File(file_id, source_name ? source_name : analyzer_mgr->GetComponentName(tag),
 		                conn, tag, is_orig);
 		id_map[file_id] = rval;
@@ -355,6 +355,14 @@ public:
 
 	uint64_t CumulativeFiles() { return cumulative_files; }
 
+	/**
+	 * Stops or resumes creating files for data that doesn't belong to any
+	 * file being analyzed yet, e.g. while shedding load.  Files already
+	 * being analyzed are not affected.
+	 * @param ignore whether to ignore new files.
+	 */
+	void SetIgnoreNewFiles(bool ignore) { ignore_new_files = ignore; }
+
 protected:
 	friend class detail::FileTimer;
 
@@ -436,6 +444,7 @@ private:
 
 	size_t cumulative_files;
 	size_t max_files;
+	bool ignore_new_files = false;
 	};
 
 /**
@@ -103,6 +103,11 @@ public:
 	PDict<InputHash>* currDict;
 	PDict<InputHash>* lastDict;
 
+	// State for readers sending incremental updates.
+	bool incremental;
+	bool duplicate_index; // An index was sent for more than one line.
+	int unmatched_updates; // Changed entries whose old line wasn't removed.
+
 	Func* pred;
 
 	EventHandlerPtr event;
@@ -135,7 +140,8 @@ public:
 
 Manager::TableStream::TableStream()
 	: Manager::Stream::Stream(TABLE_STREAM), num_idx_fields(), num_val_fields(), want_record(),
-	  tab(), rtype(), itype(), currDict(), lastDict(), pred(), event()
+	  tab(), rtype(), itype(), currDict(), lastDict(), incremental(), duplicate_index(),
+	  unmatched_updates(), pred(), event()
 	{
 	}
 
@@ -262,6 +268,9 @@ bool Manager::CreateStream(Stream* info, RecordVal* description)
 			return false;
 		}
 
+	if ( info->stream_type == TABLE_STREAM && rinfo.mode == MODE_REREAD )
+		rinfo.incremental = description->GetFieldOrDefault("incremental")->AsBool();
+
 	auto config = description->GetFieldOrDefault("config");
 	info->config = config.release()->AsTableVal();
 
@@ -715,6 +724,7 @@ bool Manager::CreateTableStream(RecordVal* fval)
 	stream->lastDict = new PDict<InputHash>;
 	stream->lastDict->SetDeleteFunc(input_hash_delete_func);
 	stream->want_record = (want_record->InternalInt() == 1);
+	stream->incremental = stream->reader->Info().incremental;
 
 	assert(stream->reader);
 	stream->reader->Init(fieldsV.size(), fields);
@@ -1195,7 +1205,10 @@ int Manager::SendEntryTable(Stream* i, const Value* const* vals)
 	InputHash* h = stream->lastDict->Lookup(idxhash);
 	if ( h )
 		{
-		// seen before
+		// seen before. In an incremental pass, the reader removes the
+		// previous line for this index as well.
+		stream->unmatched_updates++;
+
 		if ( stream->num_val_fields == 0 || h->valhash == valhash )
 			{
 			// ok, exact duplicate, move entry to new dicrionary and do nothing else.
@@ -1327,7 +1340,13 @@ int Manager::SendEntryTable(Stream* i, const Value* const* vals)
 		Unref(predidx);
 
 	auto prev = stream->currDict->Insert(idxhash, ih);
-	delete prev;
+
+	if ( prev )
+		{
+		stream->duplicate_index = true;
+		delete prev;
+		}
+
 	delete idxhash;
 
 	if ( stream->event )
@@ -1363,7 +1382,7 @@ int Manager::SendEntryTable(Stream* i, const Value* const* vals)
 	return stream->num_val_fields + stream->num_idx_fields;
 	}
 
-void Manager::EndCurrentSend(ReaderFrontend* reader)
+void Manager::EndCurrentSend(ReaderFrontend* reader, bool incremental)
 	{
 	Stream* i = FindStream(reader);
 
@@ -1390,63 +1409,57 @@ void Manager::EndCurrentSend(ReaderFrontend* reader)
 	assert(i->stream_type == TABLE_STREAM);
 	auto* stream = static_cast<TableStream*>(i);
 
-	// lastdict contains all deleted entries and should be empty apart from that
-	for ( auto it = stream->lastDict->begin_robust(); it != stream->lastDict->end_robust(); ++it )
+	if ( incremental )
 		{
-		auto lastDictIdxKey = it->GetHashKey();
-		InputHash* ih = it->GetValue<InputHash*>();
-
-		ValPtr val;
-		ValPtr predidx;
-		EnumValPtr ev;
-		int startpos = 0;
-
-		if ( stream->pred || stream->event )
+		// The reader only sent what changed and explicitly removed
+		// what is gone. lastdict still holds all unchanged entries, so
+		// merge the changes into it rather than the other way around.
+		for ( auto it = stream->currDict->begin_robust(); it != stream->currDict->end_robust();
+		      ++it )
 			{
-			auto idx = stream->tab->RecreateIndex(*ih->idxkey);
-			assert(idx != nullptr);
-			val = stream->tab->FindOrDefault(idx);
-			assert(val != nullptr);
-			predidx = {AdoptRef{}, ListValToRecordVal(idx.get(), stream->itype, &startpos)};
-			ev = BifType::Enum::Input::Event->GetEnumVal(BifEnum::Input::EVENT_REMOVED);
+			auto currDictIdxKey = it->GetHashKey();
+			auto prev = stream->lastDict->Insert(
+				currDictIdxKey.get(), stream->currDict->RemoveEntry(currDictIdxKey.get()));
+			delete prev;
 			}
 
-		if ( stream->pred )
-			{
-			// ask predicate, if we want to expire this element...
-
-			bool result = CallPred(stream->pred, 3, ev->Ref(), predidx->Ref(), val->Ref());
-
-			if ( result == false )
-				{
-				// Keep it. Hence - we quit and simply go to the next entry of lastDict
-				// ah well - and we have to add the entry to currDict...
-				stream->currDict->Insert(lastDictIdxKey.get(),
-				                         stream->lastDict->RemoveEntry(lastDictIdxKey.get()));
-				continue;
-				}
-			}
+		stream->currDict->Clear();
+		}
 
-		if ( stream->event )
+	else
+		{
+		// lastdict contains all deleted entries and should be empty apart from that
+		for ( auto it = stream->lastDict->begin_robust(); it != stream->lastDict->end_robust();
+		      ++it )
 			{
-			if ( stream->num_val_fields == 0 )
-				SendEvent(stream->event, 3, stream->description->Ref(), ev->Ref(), predidx->Ref());
-			else
-				SendEvent(stream->event, 4, stream->description->Ref(), ev->Ref(), predidx->Ref(),
-				          val->Ref());
+			auto lastDictIdxKey = it->GetHashKey();
+			ExpireTableEntry(stream, lastDictIdxKey.get());
 			}
 
-		stream->tab->Remove(*ih->idxkey);
-		stream->lastDict->Remove(lastDictIdxKey.get()); // delete in next line
-		delete ih;
+		stream->lastDict->Clear(); // should be empty. but well... who knows...
+		delete stream->lastDict;
+
+		stream->lastDict = stream->currDict;
+		stream->currDict = new PDict<InputHash>;
+		stream->currDict->SetDeleteFunc(input_hash_delete_func);
 		}
 
-	stream->lastDict->Clear(); // should be empty. but well... who knows...
-	delete stream->lastDict;
+	// Incremental updates rely on every index coming from a single line;
+	// otherwise removing a line can't tell whether its index is still
+	// present. If that doesn't hold, go back to full passes.
+	if ( stream->incremental &&
+	     (stream->duplicate_index || (incremental && stream->unmatched_updates > 0)) )
+		{
+		Warning(i,
+		        "Input stream %s has index values occurring on several lines; "
+		        "disabling incremental updates",
+		        i->name.c_str());
+		stream->incremental = false;
+		stream->reader->DisableIncremental();
+		}
 
-	stream->lastDict = stream->currDict;
-	stream->currDict = new PDict<InputHash>;
-	stream->currDict->SetDeleteFunc(input_hash_delete_func);
+	stream->duplicate_index = false;
+	stream->unmatched_updates = 0;
 
 #ifdef DEBUG
 	DBG_LOG(DBG_INPUT, "EndCurrentSend complete for stream %s", i->name.c_str());
@@ -1455,6 +1468,99 @@ void Manager::EndCurrentSend(ReaderFrontend* reader)
 	SendEndOfData(i);
 	}
 
+void Manager::ExpireTableEntry(TableStream* stream, zeek::detail::HashKey* idxhash)
+	{
+	InputHash* ih = stream->lastDict->Lookup(idxhash);
+	assert(ih);
+
+	ValPtr val;
+	ValPtr predidx;
+	EnumValPtr ev;
+	int startpos = 0;
+
+	if ( stream->pred || stream->event )
+		{
+		auto idx = stream->tab->RecreateIndex(*ih->idxkey);
+		assert(idx != nullptr);
+		val = stream->tab->FindOrDefault(idx);
+		assert(val != nullptr);
+		predidx = {AdoptRef{}, ListValToRecordVal(idx.get(), stream->itype, &startpos)};
+		ev = BifType::Enum::Input::Event->GetEnumVal(BifEnum::Input::EVENT_REMOVED);
+		}
+
+	if ( stream->pred )
+		{
+		// ask predicate, if we want to expire this element...
+
+		bool result = CallPred(stream->pred, 3, ev->Ref(), predidx->Ref(), val->Ref());
+
+		if ( result == false )
+			{
+			// Keep it. Hence - we quit and simply go to the next entry of lastDict
+			// ah well - and we have to add the entry to currDict...
+			stream->currDict->Insert(idxhash, stream->lastDict->RemoveEntry(idxhash));
+			return;
+			}
+		}
+
+	if ( stream->event )
+		{
+		if ( stream->num_val_fields == 0 )
+			SendEvent(stream->event, 3, stream->description->Ref(), ev->Ref(), predidx->Ref());
+		else
+			SendEvent(stream->event, 4, stream->description->Ref(), ev->Ref(), predidx->Ref(),
+			          val->Ref());
+		}
+
+	stream->tab->Remove(*ih->idxkey);
+	stream->lastDict->RemoveEntry(idxhash);
+	delete ih;
+	}
+
+void Manager::RemoveEntry(ReaderFrontend* reader, Value** vals)
+	{
+	Stream* i = FindStream(reader);
+
+	if ( i == nullptr )
+		{
+		reporter->InternalWarning("Unknown reader %s in RemoveEntry", reader->Name());
+		return;
+		}
+
+	if ( i->stream_type != TABLE_STREAM )
+		{
+		Warning(i, "Incremental updates are only supported for table streams");
+		Value::delete_value_ptr_array(vals, reader->NumFields());
+		return;
+		}
+
+	auto* stream = static_cast<TableStream*>(i);
+	int readFields = stream->num_idx_fields + stream->num_val_fields;
+
+	zeek::detail::HashKey* idxhash = HashValues(stream->num_idx_fields, vals);
+
+	if ( idxhash == nullptr )
+		{
+		Warning(i, "Could not hash line. Ignoring");
+		Value::delete_value_ptr_array(vals, readFields);
+		return;
+		}
+
+	if ( stream->currDict->Lookup(idxhash) )
+		// Sent again in this pass with a different value; the new entry
+		// replaces the old one.
+		stream->unmatched_updates--;
+
+	else if ( stream->lastDict->Lookup(idxhash) )
+		ExpireTableEntry(stream, idxhash);
+
+	// Otherwise the line never made it into the table, e.g. because the
+	// predicate rejected it.
+
+	delete idxhash;
+	Value::delete_value_ptr_array(vals, readFields);
+	}
+
 void Manager::SendEndOfData(ReaderFrontend* reader)
 	{
 	Stream* i = FindStream(reader);
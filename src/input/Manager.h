@@ -125,6 +125,7 @@ protected:
 	friend class ClearMessage;
 	friend class SendEntryMessage;
 	friend class EndCurrentSendMessage;
+	friend class RemoveEntryMessage;
 	friend class ReaderClosedMessage;
 	friend class DisableMessage;
 	friend class EndOfDataMessage;
@@ -144,7 +145,12 @@ protected:
 	// monitoring new/deleted values) Functions take ownership of
 	// threading::Value fields.
 	void SendEntry(ReaderFrontend* reader, threading::Value** vals);
-	void EndCurrentSend(ReaderFrontend* reader);
+	void EndCurrentSend(ReaderFrontend* reader, bool incremental = false);
+
+	// For readers in indirect mode sending incremental updates: Removes
+	// an entry that was sent in a previous pass, unless it was sent
+	// again in the current one.
+	void RemoveEntry(ReaderFrontend* reader, threading::Value** vals);
 
 	// Instantiates a new ReaderBackend of the given type (note that
 	// doing so creates a new thread!).
@@ -199,6 +205,11 @@ private:
 	// Put implementation for Table stream.
 	int PutTable(Stream* i, const threading::Value* const* vals);
 
+	// Removes the entry for the given index hash in the stream's last
+	// dictionary from its table, raising events and asking the
+	// predicate as needed.
+	void ExpireTableEntry(TableStream* stream, zeek::detail::HashKey* idxhash);
+
 	// SendEntry and Put implementation for Event stream.
 	int SendEventStreamEvent(Stream* i, EnumVal* type, const threading::Value* const* vals);
 
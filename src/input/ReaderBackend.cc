@@ -2,6 +2,9 @@
 
 #include "zeek/input/ReaderBackend.h"
 
+#include <functional>
+#include <unordered_map>
+
 #include "zeek/input/Manager.h"
 #include "zeek/input/ReaderFrontend.h"
 
@@ -103,21 +106,41 @@ private:
 	Value** val;
 	};
 
+class RemoveEntryMessage final : public threading::OutputMessage<ReaderFrontend>
+	{
+public:
+	RemoveEntryMessage(ReaderFrontend* reader, Value** val)
+		: threading::OutputMessage<ReaderFrontend>("RemoveEntry", reader), val(val)
+		{
+		}
+
+	bool Process() override
+		{
+		input_mgr->RemoveEntry(Object(), val);
+		return true;
+		}
+
+private:
+	Value** val;
+	};
+
 class EndCurrentSendMessage final : public threading::OutputMessage<ReaderFrontend>
 	{
 public:
-	EndCurrentSendMessage(ReaderFrontend* reader)
-		: threading::OutputMessage<ReaderFrontend>("EndCurrentSend", reader)
+	EndCurrentSendMessage(ReaderFrontend* reader, bool incremental)
+		: threading::OutputMessage<ReaderFrontend>("EndCurrentSend", reader),
+		  incremental(incremental)
 		{
 		}
 
 	bool Process() override
 		{
-		input_mgr->EndCurrentSend(Object());
+		input_mgr->EndCurrentSend(Object(), incremental);
 		return true;
 		}
 
 private:
+	bool incremental;
 	};
 
 class EndOfDataMessage final : public threading::OutputMessage<ReaderFrontend>
@@ -196,6 +219,97 @@ bool ReaderErrorMessage::Process()
 	return true;
 	}
 
+namespace detail
+	{
+
+/**
+ * The distinct lines of one pass over a reader's input, stored in a single
+ * buffer and indexed by their hash.
+ */
+class TrackedLines
+	{
+public:
+	// Looks up a line and flags it as seen. Returns false if the line
+	// isn't contained.
+	bool MarkSeen(std::string_view line)
+		{
+		auto [begin, end] = index.equal_range(std::hash<std::string_view>{}(line));
+
+		for ( auto i = begin; i != end; ++i )
+			{
+			auto& l = lines[i->second];
+
+			if ( Text(l) == line )
+				{
+				l.seen = true;
+				return true;
+				}
+			}
+
+		return false;
+		}
+
+	// Adds a line unless it's already contained.
+	void Add(std::string_view line)
+		{
+		auto h = std::hash<std::string_view>{}(line);
+		auto [begin, end] = index.equal_range(h);
+
+		for ( auto i = begin; i != end; ++i )
+			{
+			if ( Text(lines[i->second]) == line )
+				return;
+			}
+
+		index.emplace(h, lines.size());
+		lines.push_back({data.size(), line.size(), false});
+		data.append(line);
+		}
+
+	// Returns all lines not flagged as seen.
+	std::vector<std::string_view> Unseen() const
+		{
+		std::vector<std::string_view> rval;
+
+		for ( const auto& l : lines )
+			{
+			if ( ! l.seen )
+				rval.push_back(Text(l));
+			}
+
+		return rval;
+		}
+
+	void ClearSeen()
+		{
+		for ( auto& l : lines )
+			l.seen = false;
+		}
+
+	void Clear()
+		{
+		data.clear();
+		lines.clear();
+		index.clear();
+		}
+
+private:
+	struct Line
+		{
+		size_t offset;
+		size_t len;
+		bool seen;
+		};
+
+	std::string_view Text(const Line& l) const { return {data.data() + l.offset, l.len}; }
+
+	std::string data;
+	std::vector<Line> lines;
+	std::unordered_multimap<size_t, size_t> index; // Hash to position in lines.
+	};
+
+	} // namespace detail
+
 using namespace input;
 
 ReaderBackend::ReaderBackend(ReaderFrontend* arg_frontend) : MsgThread()
@@ -205,6 +319,8 @@ ReaderBackend::ReaderBackend(ReaderFrontend* arg_frontend) : MsgThread()
 	info = new ReaderInfo(frontend->Info());
 	num_fields = 0;
 	fields = nullptr;
+	prev_lines = std::make_unique<detail::TrackedLines>();
+	curr_lines = std::make_unique<detail::TrackedLines>();
 
 	SetName(frontend->Name());
 	}
@@ -231,7 +347,82 @@ void ReaderBackend::Clear()
 
 void ReaderBackend::EndCurrentSend()
 	{
-	SendOut(new EndCurrentSendMessage(frontend));
+	bool incremental = tracking && have_prev_lines;
+
+	if ( tracking )
+		{
+		// The lines of this pass become the reference for the next.
+		std::swap(prev_lines, curr_lines);
+		curr_lines->Clear();
+		have_prev_lines = true;
+		tracking = false;
+		}
+
+	SendOut(new EndCurrentSendMessage(frontend, incremental));
+	}
+
+void ReaderBackend::RemoveEntry(Value** vals)
+	{
+	SendOut(new RemoveEntryMessage(frontend, vals));
+	}
+
+bool ReaderBackend::IncrementalUpdates() const
+	{
+	return info->incremental && ! incremental_disabled;
+	}
+
+void ReaderBackend::StartIncrementalSend(bool reset)
+	{
+	if ( ! IncrementalUpdates() )
+		return;
+
+	// A previous pass may have been aborted half-way.
+	curr_lines->Clear();
+	prev_lines->ClearSeen();
+
+	if ( reset )
+		{
+		prev_lines->Clear();
+		have_prev_lines = false;
+		}
+
+	tracking = true;
+	}
+
+bool ReaderBackend::LineUnchanged(std::string_view line)
+	{
+	if ( ! tracking || ! have_prev_lines )
+		return false;
+
+	if ( ! prev_lines->MarkSeen(line) )
+		return false;
+
+	curr_lines->Add(line);
+	return true;
+	}
+
+void ReaderBackend::TrackLine(std::string_view line)
+	{
+	if ( tracking )
+		curr_lines->Add(line);
+	}
+
+std::vector<std::string_view> ReaderBackend::RemovedLines() const
+	{
+	if ( ! tracking || ! have_prev_lines )
+		return {};
+
+	return prev_lines->Unseen();
+	}
+
+bool ReaderBackend::DisableIncremental()
+	{
+	incremental_disabled = true;
+	tracking = false;
+	have_prev_lines = false;
+	prev_lines->Clear();
+	curr_lines->Clear();
+	return true;
 	}
 
 void ReaderBackend::EndOfData()
@@ -2,6 +2,10 @@
 
 #pragma once
 
+#include <memory>
+#include <string_view>
+#include <vector>
+
 #include "zeek/ZeekString.h"
 #include "zeek/input/Component.h"
 #include "zeek/threading/MsgThread.h"
@@ -12,6 +16,11 @@ namespace zeek::input
 
 class ReaderFrontend;
 
+namespace detail
+	{
+class TrackedLines;
+	}
+
 /**
  * The modes a reader can be in.
  */
@@ -103,11 +112,19 @@ public:
 		 */
 		ReaderMode mode;
 
+		/**
+		 * True if the manager accepts incremental updates for this
+		 * stream: after the first full pass, a reader sending its data
+		 * through SendEntry() only needs to send entries that changed.
+		 */
+		bool incremental;
+
 		ReaderInfo()
 			{
 			source = nullptr;
 			name = nullptr;
 			mode = MODE_NONE;
+			incremental = false;
 			}
 
 		ReaderInfo(const ReaderInfo& other)
@@ -115,6 +132,7 @@ public:
 			source = other.source ? util::copy_string(other.source) : nullptr;
 			name = other.name ? util::copy_string(other.name) : nullptr;
 			mode = other.mode;
+			incremental = other.incremental;
 
 			for ( config_map::const_iterator i = other.config.begin(); i != other.config.end();
 			      i++ )
@@ -172,6 +190,15 @@ public:
 	 */
 	void DisableFrontend();
 
+	/**
+	 * Switches the reader back to sending all entries on every pass
+	 * over the input. The manager requests this when it cannot apply
+	 * incremental updates to the stream correctly.
+	 *
+	 * @return Always true.
+	 */
+	bool DisableIncremental();
+
 	/**
 	 * Returns the log fields as passed into the constructor.
 	 */
@@ -349,10 +376,65 @@ protected:
 	 *
 	 * For table streams, all entries that were not updated since the
 	 * last EndCurrentSend will be deleted, because they are no longer
-	 * present in the input source
+	 * present in the input source. In an incremental pass, only the
+	 * entries passed to RemoveEntry() are deleted.
 	 */
 	void EndCurrentSend();
 
+	// Incremental tracking mode: Readers whose entries each derive from
+	// one line of text can use these functions to only send lines that
+	// changed since the previous pass.
+
+	/**
+	 * Returns true if the reader may send incremental updates, see
+	 * ReaderInfo::incremental.
+	 */
+	bool IncrementalUpdates() const;
+
+	/**
+	 * Starts tracking the lines of a new pass over the input. Must be
+	 * called before the first line of each pass if IncrementalUpdates()
+	 * returns true; the pass ends with EndCurrentSend().
+	 *
+	 * @param reset True if lines of the previous pass cannot be compared
+	 * with the new ones, e.g. because the input's format changed. The
+	 * pass then sends all lines again.
+	 */
+	void StartIncrementalSend(bool reset);
+
+	/**
+	 * Checks whether a line was already present in the previous pass,
+	 * in which case the reader must not send it again.
+	 *
+	 * @return True if the line is unchanged.
+	 */
+	bool LineUnchanged(std::string_view line);
+
+	/**
+	 * Records a line that has been sent with SendEntry() during the
+	 * current pass, so that the next pass can recognize it.
+	 */
+	void TrackLine(std::string_view line);
+
+	/**
+	 * Returns the lines of the previous pass that neither
+	 * LineUnchanged() found nor TrackLine() recorded in the current pass.
+	 * The reader needs to convert these and pass them to RemoveEntry()
+	 * before calling EndCurrentSend(). The returned data remains valid
+	 * until then.
+	 */
+	std::vector<std::string_view> RemovedLines() const;
+
+	/**
+	 * Method allowing a reader to tell the manager in tracking mode that
+	 * an entry sent in an earlier pass is no longer present. Entries
+	 * sent with SendEntry() in the current pass take precedence.
+	 *
+	 * @param val Array of threading::Values expected by the stream. The
+	 * array must have exactly NumEntries() elements.
+	 */
+	void RemoveEntry(threading::Value** vals);
+
 private:
 	// Frontend that instantiated us. This object must not be accessed
 	// from this class, it's running in a different thread!
@@ -363,6 +445,14 @@ private:
 	const threading::Field* const* fields; // raw mapping
 
 	bool disabled;
+
+	// Lines of the previous and current pass in incremental mode.
+	std::unique_ptr<detail::TrackedLines> prev_lines;
+	std::unique_ptr<detail::TrackedLines> curr_lines;
+	bool incremental_disabled = false;
+	bool tracking = false; // True while an incremental pass is running.
+	bool have_prev_lines = false;
+
 	// this is an internal indicator in case the read is currently in a failed state
 	// it's used to suppress duplicate error messages.
 	bool suppress_warnings = false;
@@ -35,6 +35,17 @@ public:
 	bool Process() override { return Object()->Update(); }
 	};
 
+class DisableIncrementalMessage final : public threading::InputMessage<ReaderBackend>
+	{
+public:
+	DisableIncrementalMessage(ReaderBackend* backend)
+		: threading::InputMessage<ReaderBackend>("DisableIncremental", backend)
+		{
+		}
+
+	bool Process() override { return Object()->DisableIncremental(); }
+	};
+
 ReaderFrontend::ReaderFrontend(const ReaderBackend::ReaderInfo& arg_info, EnumVal* type)
 	{
 	disabled = initialized = false;
@@ -92,6 +103,14 @@ void ReaderFrontend::Update()
 	backend->SendIn(new UpdateMessage(backend));
 	}
 
+void ReaderFrontend::DisableIncremental()
+	{
+	if ( disabled || ! initialized )
+		return;
+
+	backend->SendIn(new DisableIncrementalMessage(backend));
+	}
+
 const char* ReaderFrontend::Name() const
 	{
 	return name;
@@ -71,6 +71,18 @@ public:
 	 */
 	void Update();
 
+	/**
+	 * Makes the reader send all entries on each pass over the input
+	 * again, rather than only the ones that changed. See
+	 * ReaderBackend::ReaderInfo::incremental.
+	 *
+	 * This method generates a message to the backend reader and triggers
+	 * the corresponding message there.
+	 *
+	 * This method must only be called from the main thread.
+	 */
+	void DisableIncremental();
+
 	/**
 	 * Finalizes reading from this stream.
 	 *
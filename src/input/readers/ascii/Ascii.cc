@@ -3,10 +3,15 @@
 #include "zeek/input/readers/ascii/Ascii.h"
 
 #include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
+#include <algorithm>
+#include <cstring>
 #include <sstream>
+#include <thread>
 
 #include "zeek/input/readers/ascii/ascii.bif.h"
 #include "zeek/threading/SerialTypes.h"
@@ -18,6 +23,76 @@ using zeek::threading::Value;
 namespace zeek::input::reader::detail
 	{
 
+// Amount of a memory-mapped file each parse thread scans per round. This
+// bounds the memory needed for the field offsets of a round.
+static constexpr size_t MAPPED_ROUND_SIZE = 16 * 1024 * 1024;
+
+// Splits a line at the separator, appending the fields to the given
+// vector. Like reading fields with getline(), this does not produce a
+// trailing empty field if the line ends with the separator.
+static void split_line(std::string_view line, char sep, std::vector<std::string_view>* fields)
+	{
+	size_t start = 0;
+
+	while ( start < line.size() )
+		{
+		auto p = static_cast<const char*>(
+			memchr(line.data() + start, sep, line.size() - start));
+		size_t stop = p ? p - line.data() : line.size();
+		fields->emplace_back(line.substr(start, stop - start));
+		start = stop + 1;
+		}
+	}
+
+/**
+ * The data lines of one part of a memory-mapped input file, tokenized in
+ * place.
+ */
+struct MappedChunk
+	{
+	const char* begin = nullptr;
+	const char* end = nullptr;
+
+	std::vector<std::string_view> lines;
+	std::vector<std::string_view> fields; // Fields of all lines, in order.
+	std::vector<size_t> first_field; // Per line, index of its first field.
+
+	// Finds the chunk's data lines, applying the same rules as
+	// Ascii::GetLine(), and splits them into fields.
+	void Scan(char sep)
+		{
+		const char* p = begin;
+
+		while ( p < end )
+			{
+			auto nl = static_cast<const char*>(memchr(p, '\n', end - p));
+			const char* eol = nl ? nl : end;
+			std::string_view line(p, eol - p);
+			p = eol + 1;
+
+			if ( line.empty() )
+				continue;
+
+			if ( line.back() == '\r' ) // deal with \r\n by removing \r
+				line.remove_suffix(1);
+
+			if ( ! line.empty() && line[0] == '#' )
+				{
+				if ( line.size() > 8 && line.compare(0, 7, "#fields") == 0 && line[7] == sep )
+					line.remove_prefix(8);
+				else
+					continue;
+				}
+
+			lines.push_back(line);
+			first_field.push_back(fields.size());
+			split_line(line, sep, &fields);
+			}
+
+		first_field.push_back(fields.size());
+		}
+	};
+
 FieldMapping::FieldMapping(const string& arg_name, const TypeTag& arg_type, int arg_position)
 	: name(arg_name), type(arg_type), subtype(TYPE_ERROR)
 	{
@@ -53,6 +128,8 @@ Ascii::Ascii(ReaderFrontend* frontend) : ReaderBackend(frontend)
 	ino = 0;
 	fail_on_file_problem = false;
 	fail_on_invalid_lines = false;
+	use_mmap = false;
+	parse_threads = 0;
 	}
 
 Ascii::~Ascii() { }
@@ -81,6 +158,9 @@ bool Ascii::DoInit(const ReaderInfo& info, int num_fields, const Field* const* f
 	path_prefix.assign((const char*)BifConst::InputAscii::path_prefix->Bytes(),
 	                   BifConst::InputAscii::path_prefix->Len());
 
+	use_mmap = BifConst::InputAscii::use_mmap;
+	parse_threads = BifConst::InputAscii::parse_threads;
+
 	// Set per-filter configuration options.
 	for ( ReaderInfo::config_map::const_iterator i = info.config.begin(); i != info.config.end();
 	      i++ )
@@ -102,6 +182,12 @@ bool Ascii::DoInit(const ReaderInfo& info, int num_fields, const Field* const* f
 
 		else if ( strcmp(i->first, "fail_on_file_problem") == 0 )
 			fail_on_file_problem = (strncmp(i->second, "T", 1) == 0);
+
+		else if ( strcmp(i->first, "use_mmap") == 0 )
+			use_mmap = (strncmp(i->second, "T", 1) == 0);
+
+		else if ( strcmp(i->first, "parse_threads") == 0 )
+			parse_threads = atoi(i->second);
 		}
 
 	if ( separator.size() != 1 )
@@ -338,122 +424,299 @@ bool Ascii::DoUpdate()
 			assert(false);
 		}
 
+	if ( IncrementalUpdates() )
+		{
+		// Lines can only be compared with the previous pass if the
+		// columns stayed the same.
+		StartIncrementalSend(headerline != tracked_headerline);
+		tracked_headerline = headerline;
+		}
+
+	if ( use_mmap && Info().mode != MODE_STREAM )
+		{
+		// The stream has just read the header, continue from there.
+		std::streamoff data_start = file.tellg();
+
+		if ( data_start >= 0 )
+			{
+			bool fallback = false;
+
+			if ( ! ReadMapped(data_start, &fallback) )
+				return false;
+
+			if ( ! fallback )
+				{
+				SendRemovedLines();
+				EndCurrentSend();
+				return true;
+				}
+			}
+		}
+
 	string line;
+	vector<std::string_view> fields;
 
 	file.sync();
 
 	while ( GetLine(line) )
 		{
-		// split on tabs
-		bool error = false;
-		istringstream splitstream(line);
+		if ( LineUnchanged(line) )
+			continue;
 
-		map<int, string> stringfields;
-		int pos = 0;
-		while ( splitstream )
+		SplitLine(line, &fields);
+
+		Value** vals;
+
+		switch ( ConvertLine(line, fields.data(), fields.size(), &vals) )
 			{
-			string s;
-			if ( ! getline(splitstream, s, separator[0]) )
+			case LineResult::OK:
+				SendLine(vals);
+				TrackLine(line);
 				break;
 
-			stringfields[pos] = s;
-			pos++;
+			case LineResult::SKIP:
+				break;
+
+			case LineResult::FAIL:
+				return false;
 			}
+		}
+
+	if ( Info().mode != MODE_STREAM )
+		{
+		SendRemovedLines();
+		EndCurrentSend();
+		}
+
+	return true;
+	}
 
-		pos--; // for easy comparisons of max element.
+void Ascii::SendRemovedLines()
+	{
+	vector<std::string_view> fields;
+
+	for ( const auto& line : RemovedLines() )
+		{
+		SplitLine(line, &fields);
+
+		// These lines converted fine when they were added.
+		Value** vals;
+		if ( ConvertLine(line, fields.data(), fields.size(), &vals) == LineResult::OK )
+			RemoveEntry(vals);
+		}
+	}
 
-		Value** fields = new Value*[NumFields()];
+void Ascii::SplitLine(std::string_view line, std::vector<std::string_view>* fields) const
+	{
+	fields->clear();
+	split_line(line, separator[0], fields);
+	}
+
+Ascii::LineResult Ascii::ConvertLine(std::string_view line, const std::string_view* fields,
+                                     size_t num_fields, Value*** vals)
+	{
+	int pos = static_cast<int>(num_fields) - 1; // for easy comparisons of max element.
 
-		int fpos = 0;
-		for ( vector<FieldMapping>::iterator fit = columnMap.begin(); fit != columnMap.end();
-		      fit++ )
+	Value** fvals = new Value*[NumFields()];
+	LineResult result = LineResult::OK;
+
+	int fpos = 0;
+	for ( const auto& fit : columnMap )
+		{
+		if ( ! fit.present )
 			{
+			// add non-present field
+			fvals[fpos] = new Value(fit.type, false);
+			fpos++;
+			continue;
+			}
 
-			if ( ! fit->present )
-				{
-				// add non-present field
-				fields[fpos] = new Value((*fit).type, false);
-				fpos++;
-				continue;
-				}
+		assert(fit.position >= 0);
+
+		if ( fit.position > pos || fit.secondary_position > pos )
+			{
+			FailWarn(fail_on_invalid_lines,
+			         Fmt("Not enough fields in line '%s' of %s. Found "
+			             "%d fields, want positions %d and %d",
+			             std::string(line).c_str(), fname.c_str(), pos, fit.position,
+			             fit.secondary_position));
 
-			assert(fit->position >= 0);
+			result = fail_on_invalid_lines ? LineResult::FAIL : LineResult::SKIP;
+			break;
+			}
 
-			if ( (*fit).position > pos || (*fit).secondary_position > pos )
-				{
-				FailWarn(fail_on_invalid_lines, Fmt("Not enough fields in line '%s' of %s. Found "
-				                                    "%d fields, want positions %d and %d",
-				                                    line.c_str(), fname.c_str(), pos,
-				                                    (*fit).position, (*fit).secondary_position));
+		field_buf.assign(fields[fit.position]);
+		Value* val = formatter->ParseValue(field_buf, fit.name, fit.type, fit.subtype);
 
-				if ( fail_on_invalid_lines )
-					{
-					for ( int i = 0; i < fpos; i++ )
-						delete fields[i];
+		if ( ! val )
+			{
+			Warning(Fmt("Could not convert line '%s' of %s to Val. Ignoring line.",
+			            std::string(line).c_str(), fname.c_str()));
+			result = LineResult::SKIP;
+			break;
+			}
 
-					delete[] fields;
+		if ( fit.secondary_position != -1 )
+			{
+			// we have a port definition :)
+			assert(val->type == TYPE_PORT);
+			//	Error(Fmt("Got type %d != PORT with secondary position!", val->type));
 
-					return false;
-					}
-				else
-					{
-					error = true;
-					break;
-					}
-				}
+			field_buf.assign(fields[fit.secondary_position]);
+			val->val.port_val.proto = formatter->ParseProto(field_buf);
+			}
 
-			Value* val = formatter->ParseValue(stringfields[(*fit).position], (*fit).name,
-			                                   (*fit).type, (*fit).subtype);
+		fvals[fpos] = val;
 
-			if ( ! val )
-				{
-				Warning(Fmt("Could not convert line '%s' of %s to Val. Ignoring line.",
-				            line.c_str(), fname.c_str()));
-				error = true;
-				break;
-				}
+		fpos++;
+		}
 
-			if ( (*fit).secondary_position != -1 )
-				{
-				// we have a port definition :)
-				assert(val->type == TYPE_PORT);
-				//	Error(Fmt("Got type %d != PORT with secondary position!", val->type));
+	if ( result != LineResult::OK )
+		{
+		// Encountered an error, ignoring line. But first, delete all
+		// successfully read fields and the array structure.
+		for ( int i = 0; i < fpos; i++ )
+			delete fvals[i];
 
-				val->val.port_val.proto = formatter->ParseProto(
-					stringfields[(*fit).secondary_position]);
-				}
+		delete[] fvals;
+		return result;
+		}
+
+	assert(fpos == NumFields());
+	*vals = fvals;
+	return result;
+	}
 
-			fields[fpos] = val;
+void Ascii::SendLine(Value** vals)
+	{
+	if ( Info().mode == MODE_STREAM )
+		Put(vals);
+	else
+		SendEntry(vals);
+	}
 
-			fpos++;
+bool Ascii::ReadMapped(size_t data_start, bool* fallback)
+	{
+	int fd = open(fname.c_str(), O_RDONLY);
+	struct stat sb;
+
+	if ( fd < 0 || fstat(fd, &sb) < 0 || ! S_ISREG(sb.st_mode) )
+		{
+		if ( fd >= 0 )
+			close(fd);
+
+		*fallback = true;
+		return true;
+		}
+
+	size_t size = sb.st_size;
+
+	if ( size <= data_start )
+		{
+		// Nothing but the header.
+		close(fd);
+		return true;
+		}
+
+	void* map = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+
+	if ( map == MAP_FAILED )
+		{
+		*fallback = true;
+		return true;
+		}
+
+	madvise(map, size, MADV_SEQUENTIAL);
+
+	// For one-time reads of large files, split the tokenizing across
+	// several threads. The conversion into values stays with this
+	// thread, as the formatter reports problems through it.
+	int num_chunks = 1;
+
+	if ( Info().mode == MODE_MANUAL && parse_threads > 1 )
+		num_chunks = parse_threads;
+
+	const char* p = static_cast<const char*>(map) + data_start;
+	const char* end = static_cast<const char*>(map) + size;
+	char sep = separator[0];
+	bool success = true;
+
+	vector<MappedChunk> chunks(num_chunks);
+
+	while ( p < end && success )
+		{
+		// Divide up the next round at line boundaries.
+		size_t round_size = std::min<size_t>(end - p, num_chunks * MAPPED_ROUND_SIZE);
+		const char* round_end = p + round_size;
+
+		if ( round_end < end )
+			{
+			auto nl = static_cast<const char*>(memchr(round_end, '\n', end - round_end));
+			round_end = nl ? nl + 1 : end;
 			}
 
-		if ( error )
+		for ( int i = 0; i < num_chunks; ++i )
 			{
-			// Encountered non-fatal error, ignoring line. But
-			// first, delete all successfully read fields and the
-			// array structure.
+			auto& c = chunks[i];
+			c.lines.clear();
+			c.fields.clear();
+			c.first_field.clear();
 
-			for ( int i = 0; i < fpos; i++ )
-				delete fields[i];
+			c.begin = i == 0 ? p : chunks[i - 1].end;
+			c.end = round_end;
 
-			delete[] fields;
-			continue;
+			if ( i < num_chunks - 1 )
+				{
+				const char* split = std::max(c.begin, p + (round_end - p) * (i + 1) / num_chunks);
+				auto nl = static_cast<const char*>(memchr(split, '\n', round_end - split));
+				c.end = nl ? nl + 1 : round_end;
+				}
 			}
 
-		// printf("fpos: %d, second.num_fields: %d\n", fpos, (*it).second.num_fields);
-		assert(fpos == NumFields());
+		vector<std::thread> threads;
 
-		if ( Info().mode == MODE_STREAM )
-			Put(fields);
-		else
-			SendEntry(fields);
-		}
+		for ( int i = 1; i < num_chunks; ++i )
+			threads.emplace_back(&MappedChunk::Scan, &chunks[i], sep);
 
-	if ( Info().mode != MODE_STREAM )
-		EndCurrentSend();
+		chunks[0].Scan(sep);
 
-	return true;
+		for ( auto& t : threads )
+			t.join();
+
+		for ( const auto& c : chunks )
+			{
+			for ( size_t i = 0; i < c.lines.size() && success; ++i )
+				{
+				if ( LineUnchanged(c.lines[i]) )
+					continue;
+
+				size_t first = c.first_field[i];
+				size_t num = c.first_field[i + 1] - first;
+				Value** vals;
+
+				switch ( ConvertLine(c.lines[i], c.fields.data() + first, num, &vals) )
+					{
+					case LineResult::OK:
+						SendLine(vals);
+						TrackLine(c.lines[i]);
+						break;
+
+					case LineResult::SKIP:
+						break;
+
+					case LineResult::FAIL:
+						success = false;
+						break;
+					}
+				}
+			}
+
+		p = round_end;
+		}
+
+	munmap(map, size);
+	return success;
 	}
 
 bool Ascii::DoHeartbeat(double network_time, double current_time)
@@ -6,6 +6,7 @@
 #include <fstream>
 #include <iostream>
 #include <memory>
+#include <string_view>
 #include <vector>
 
 #include "zeek/input/ReaderBackend.h"
@@ -63,10 +64,39 @@ protected:
 	bool DoHeartbeat(double network_time, double current_time) override;
 
 private:
+	// Outcome of converting a line into values.
+	enum class LineResult
+		{
+		OK, // Converted successfully.
+		SKIP, // Invalid, but reading may continue.
+		FAIL, // Invalid, and reading must stop.
+		};
+
 	bool ReadHeader(bool useCached);
 	bool GetLine(std::string& str);
 	bool OpenFile();
 
+	// Splits a line at the separator. The resulting fields point into
+	// the line's memory.
+	void SplitLine(std::string_view line, std::vector<std::string_view>* fields) const;
+
+	// Converts a line's fields into values according to the column map.
+	// On success, the caller takes ownership of the array in *vals.
+	LineResult ConvertLine(std::string_view line, const std::string_view* fields,
+	                       size_t num_fields, threading::Value*** vals);
+
+	// Hands a converted line over to the manager.
+	void SendLine(threading::Value** vals);
+
+	// In incremental mode, tells the manager about lines that are gone
+	// since the previous pass.
+	void SendRemovedLines();
+
+	// Reads the file's data lines starting at the given offset from a
+	// memory mapping rather than through the stream. Returns false on
+	// fatal errors, setting *fallback if the file couldn't be mapped.
+	bool ReadMapped(size_t data_start, bool* fallback);
+
 	std::ifstream file;
 	time_t mtime;
 	ino_t ino;
@@ -82,6 +112,9 @@ private:
 	// keep a copy of the headerline to determine field locations when stream descriptions change
 	std::string headerline;
 
+	// the headerline of the previous pass in incremental mode
+	std::string tracked_headerline;
+
 	// options set from the script-level.
 	std::string separator;
 	std::string set_separator;
@@ -90,6 +123,10 @@ private:
 	bool fail_on_invalid_lines;
 	bool fail_on_file_problem;
 	std::string path_prefix;
+	bool use_mmap;
+	int parse_threads;
+
+	std::string field_buf; // Reused for passing fields to the formatter.
 
 	std::unique_ptr<threading::Formatter> formatter;
 	};
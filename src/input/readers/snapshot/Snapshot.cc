@@ -0,0 +1,336 @@
+// See the file "COPYING" in the main distribution directory for copyright.
+
+#include "zeek/input/readers/snapshot/Snapshot.h"
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+
+#include "zeek/threading/SerialTypes.h"
+#include "zeek/threading/Snapshot.h"
+
+using namespace std;
+using zeek::threading::Field;
+using zeek::threading::Value;
+
+namespace zeek::input::reader::detail
+	{
+
+// Splits the next length-prefixed block off the front of data. Returns
+// false if data doesn't hold a complete block.
+static bool next_block(std::string_view* data, std::string_view* block)
+	{
+	uint32_t nlen;
+
+	if ( data->size() < sizeof(nlen) )
+		return false;
+
+	memcpy(&nlen, data->data(), sizeof(nlen));
+	size_t len = ntohl(nlen);
+
+	if ( data->size() - sizeof(nlen) < len )
+		return false;
+
+	*block = data->substr(sizeof(nlen), len);
+	data->remove_prefix(sizeof(nlen) + len);
+	return true;
+	}
+
+Snapshot::Snapshot(ReaderFrontend* frontend) : ReaderBackend(frontend)
+	{
+	// Without quiet mode, a short or damaged block makes the format call
+	// the reporter, which must not happen on this thread, and abort.
+	fmt.SetQuiet();
+	}
+
+Snapshot::~Snapshot()
+	{
+	for ( auto v : row )
+		delete v;
+	}
+
+bool Snapshot::DoInit(const ReaderInfo& info, int num_fields, const Field* const* fields)
+	{
+	if ( ! info.source || strlen(info.source) == 0 )
+		{
+		Error("No source path provided");
+		return false;
+		}
+
+	if ( info.mode == MODE_STREAM )
+		{
+		Error("Snapshot reader does not support STREAM mode");
+		return false;
+		}
+
+	fname = info.source;
+	return DoUpdate();
+	}
+
+bool Snapshot::DoUpdate()
+	{
+	struct stat sb;
+
+	if ( stat(fname.c_str(), &sb) == -1 )
+		{
+		// Only fatal the first time around; in REREAD mode the file
+		// may be in the process of being replaced.
+		FailWarn(firstrun, Fmt("Could not get stat for %s", fname.c_str()), true);
+		return ! firstrun;
+		}
+
+	if ( ! firstrun && Info().mode == MODE_REREAD && sb.st_ino == ino && sb.st_mtime == mtime )
+		// no change
+		return true;
+
+	firstrun = false;
+	mtime = sb.st_mtime;
+	ino = sb.st_ino;
+
+	return ReadFile();
+	}
+
+bool Snapshot::ReadFile()
+	{
+	int fd = open(fname.c_str(), O_RDONLY);
+
+	if ( fd < 0 )
+		{
+		FailWarn(false, Fmt("Cannot open %s: %s", fname.c_str(), Strerror(errno)), true);
+		return true;
+		}
+
+	struct stat sb;
+
+	if ( fstat(fd, &sb) < 0 )
+		{
+		FailWarn(false, Fmt("Could not get stat for %s", fname.c_str()), true);
+		close(fd);
+		return true;
+		}
+
+	size_t size = sb.st_size;
+	void* map = size > 0 ? mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+	close(fd);
+
+	if ( map == MAP_FAILED )
+		{
+		FailWarn(false, Fmt("Cannot map %s: %s", fname.c_str(), Strerror(errno)), true);
+		return true;
+		}
+
+	StopWarningSuppression();
+	madvise(map, size, MADV_SEQUENTIAL);
+
+	std::string_view data(static_cast<const char*>(map), size);
+	std::string_view block;
+	bool success = true;
+
+	if ( data.substr(0, sizeof(threading::snapshot::MAGIC)) !=
+	     std::string_view(threading::snapshot::MAGIC, sizeof(threading::snapshot::MAGIC)) )
+		{
+		Error(Fmt("%s is not a snapshot file", fname.c_str()));
+		success = false;
+		}
+
+	else
+		{
+		data.remove_prefix(sizeof(threading::snapshot::MAGIC));
+
+		if ( ! next_block(&data, &block) || ! ReadHeader(block) )
+			success = false;
+		}
+
+	if ( success )
+		{
+		if ( IncrementalUpdates() )
+			{
+			// Rows can only be compared with the previous pass if the
+			// file has the same columns.
+			StartIncrementalSend(header != tracked_header);
+			tracked_header = header;
+			}
+
+		// The rows' serialized form serves as the "line" for
+		// incremental updates.
+		while ( next_block(&data, &block) )
+			{
+			if ( LineUnchanged(block) )
+				continue;
+
+			if ( Value** vals = ReadRow(block) )
+				{
+				SendEntry(vals);
+				TrackLine(block);
+				}
+			}
+
+		if ( ! data.empty() )
+			Warning(Fmt("Ignoring truncated row at end of %s", fname.c_str()));
+
+		for ( const auto& removed : RemovedLines() )
+			{
+			if ( Value** vals = ReadRow(removed) )
+				RemoveEntry(vals);
+			}
+
+		EndCurrentSend();
+		}
+
+	munmap(map, size);
+	return success;
+	}
+
+bool Snapshot::ReadHeader(std::string_view block)
+	{
+	uint32_t version;
+	uint32_t num_fields;
+
+	fmt.StartRead(block.data(), block.size());
+
+	if ( ! (fmt.Read(&version, "version") && fmt.Read(&num_fields, "num_fields")) )
+		{
+		Error(Fmt("Cannot read header of %s", fname.c_str()));
+		return false;
+		}
+
+	if ( version != threading::snapshot::VERSION )
+		{
+		Error(Fmt("Unsupported snapshot version %u in %s", version, fname.c_str()));
+		return false;
+		}
+
+	vector<Field> file_fields;
+
+	for ( uint32_t i = 0; i < num_fields; ++i )
+		{
+		Field f(nullptr, nullptr, TYPE_ERROR, TYPE_ERROR, false);
+
+		if ( ! f.Read(&fmt) )
+			{
+			Error(Fmt("Cannot read header of %s", fname.c_str()));
+			return false;
+			}
+
+		file_fields.push_back(f);
+		}
+
+	fmt.EndRead();
+
+	columns.clear();
+
+	for ( int i = 0; i < NumFields(); ++i )
+		{
+		const Field* field = Fields()[i];
+		int pos = -1;
+
+		for ( size_t j = 0; j < file_fields.size(); ++j )
+			{
+			if ( strcmp(field->name, file_fields[j].name) == 0 )
+				{
+				pos = j;
+				break;
+				}
+			}
+
+		if ( pos < 0 )
+			{
+			if ( ! field->optional )
+				{
+				Error(Fmt("Did not find requested field %s in snapshot %s", field->name,
+				          fname.c_str()));
+				return false;
+				}
+			}
+
+		else if ( field->type != file_fields[pos].type ||
+		          ((field->type == TYPE_TABLE || field->type == TYPE_VECTOR) &&
+		           field->subtype != file_fields[pos].subtype) )
+			{
+			Error(Fmt("Field %s in snapshot %s has type %s, but %s was requested", field->name,
+			          fname.c_str(), file_fields[pos].TypeName().c_str(),
+			          field->TypeName().c_str()));
+			return false;
+			}
+
+		columns.push_back(pos);
+		}
+
+	file_num_fields = num_fields;
+	header = block;
+
+	for ( auto v : row )
+		delete v;
+
+	row.assign(file_num_fields, nullptr);
+
+	return true;
+	}
+
+Value** Snapshot::ReadRow(std::string_view block)
+	{
+	fmt.StartRead(block.data(), block.size());
+
+	for ( int i = 0; i < file_num_fields; ++i )
+		{
+		row[i] = new Value();
+
+		// A row must consume its block exactly.
+		bool last = (i == file_num_fields - 1);
+
+		if ( ! row[i]->Read(&fmt) || (last && fmt.BytesLeft() > 0) )
+			{
+			Warning(Fmt("Ignoring corrupt row in %s", fname.c_str()));
+
+			for ( int j = 0; j <= i; ++j )
+				{
+				delete row[j];
+				row[j] = nullptr;
+				}
+
+			fmt.EndRead();
+			return nullptr;
+			}
+		}
+
+	fmt.EndRead();
+
+	Value** vals = new Value*[NumFields()];
+
+	for ( int i = 0; i < NumFields(); ++i )
+		{
+		int pos = columns[i];
+
+		if ( pos < 0 )
+			vals[i] = new Value(Fields()[i]->type, false);
+		else
+			{
+			vals[i] = row[pos];
+			row[pos] = nullptr;
+			}
+		}
+
+	// Drop the columns that weren't requested.
+	for ( auto& v : row )
+		{
+		delete v;
+		v = nullptr;
+		}
+
+	return vals;
+	}
+
+bool Snapshot::DoHeartbeat(double network_time, double current_time)
+	{
+	if ( Info().mode == MODE_REREAD )
+		Update(); // call update and not DoUpdate, because update
+		          // checks disabled.
+
+	return true;
+	}
+
+	} // namespace zeek::input::reader::detail
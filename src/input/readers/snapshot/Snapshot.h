@@ -0,0 +1,58 @@
+// See the file "COPYING" in the main distribution directory for copyright.
+
+#pragma once
+
+#include <sys/types.h>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "zeek/SerializationFormat.h"
+#include "zeek/input/ReaderBackend.h"
+
+namespace zeek::input::reader::detail
+	{
+
+/**
+ * Reader for the binary snapshot files written by the snapshot log writer.
+ * It maps the file into memory and deserializes the stored
+ * threading::Values directly, avoiding the text parsing of the ASCII
+ * reader. Supports the MANUAL and REREAD modes.
+ */
+class Snapshot : public ReaderBackend
+	{
+public:
+	explicit Snapshot(ReaderFrontend* frontend);
+	~Snapshot() override;
+
+	static ReaderBackend* Instantiate(ReaderFrontend* frontend) { return new Snapshot(frontend); }
+
+protected:
+	bool DoInit(const ReaderInfo& info, int arg_num_fields,
+	            const threading::Field* const* fields) override;
+	void DoClose() override { }
+	bool DoUpdate() override;
+	bool DoHeartbeat(double network_time, double current_time) override;
+
+private:
+	bool ReadFile();
+	bool ReadHeader(std::string_view block);
+	threading::Value** ReadRow(std::string_view block);
+
+	std::string fname;
+	time_t mtime = 0;
+	ino_t ino = 0;
+	bool firstrun = true;
+
+	// Position of each requested field in the file's rows, or -1 for
+	// optional fields the file doesn't have.
+	std::vector<int> columns;
+	int file_num_fields = 0;
+	std::string header; // Header block of the current file.
+	std::string tracked_header; // Header block of the previous pass.
+
+	std::vector<threading::Value*> row; // Reused while reading rows.
+	zeek::detail::BinarySerializationFormat fmt;
+	};
+
+	} // namespace zeek::input::reader::detail
@@ -8,6 +8,7 @@
 
 #include "zeek/Hash.h"
 #include "zeek/RunState.h"
+#include "zeek/Stats.h"
 #include "zeek/broker/Manager.h"
 #include "zeek/iosource/BPF_Program.h"
 #include "zeek/iosource/Manager.h"
@@ -148,13 +149,31 @@ void PktSrc::Process()
 	if ( ! IsOpen() )
 		return;
 
+	auto profiler = zeek::detail::packet_stage_profiler;
+
+	// Only calls that actually yield a packet count towards sampling, so
+	// the extract stage's start is taken before knowing whether this one
+	// is sampled.
+	uint64_t extract_start = profiler ? zeek::detail::profile_ticks() : 0;
+
 	if ( ! ExtractNextPacketInternal() )
 		return;
 
+	if ( profiler )
+		{
+		profiler->StartPacket();
+
+		if ( profiler->Sampling() )
+			profiler->End(zeek::detail::PacketStage::Extract, extract_start);
+		}
+
 	run_state::detail::dispatch_packet(&current_packet, this);
 
 	have_packet = false;
 	DoneWithPacket();
+
+	if ( profiler )
+		profiler->FinishPacket();
 	}
 
 const char* PktSrc::Tag()
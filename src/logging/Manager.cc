@@ -49,6 +49,8 @@ struct Manager::Filter
 	bool remote = false;
 	double interval = 0.0;
 	Func* postprocessor = nullptr;
+	uint64_t max_queued_rows = 0;
+	int backpressure_policy = 0;
 
 	int num_fields = 0;
 	threading::Field** fields = nullptr;
@@ -568,6 +570,8 @@ bool Manager::AddFilter(EnumVal* id, RecordVal* fval)
 	auto scope_sep = fval->GetFieldOrDefault("scope_sep");
 	auto ext_prefix = fval->GetFieldOrDefault("ext_prefix");
 	auto ext_func = fval->GetFieldOrDefault("ext_func");
+	auto max_queued_rows = fval->GetFieldOrDefault("max_queued_rows");
+	auto backpressure_policy = fval->GetFieldOrDefault("backpressure_policy");
 
 	Filter* filter = new Filter;
 	filter->fval = fval->Ref();
@@ -585,6 +589,8 @@ bool Manager::AddFilter(EnumVal* id, RecordVal* fval)
 	filter->scope_sep = scope_sep->AsString()->CheckString();
 	filter->ext_prefix = ext_prefix->AsString()->CheckString();
 	filter->ext_func = ext_func ? ext_func->AsFunc() : nullptr;
+	filter->max_queued_rows = max_queued_rows->AsCount();
+	filter->backpressure_policy = backpressure_policy->AsEnum();
 
 	// Build the list of fields that the filter wants included, including
 	// potentially rolling out fields.
@@ -1186,6 +1192,8 @@ WriterFrontend* Manager::CreateWriter(EnumVal* id, EnumVal* writer, WriterBacken
 	// rotation settings.  If no matching filter is found, fall back on
 	// looking up the logging framework's default rotation interval.
 	bool found_filter_match = false;
+	uint64_t max_queued_rows = 0;
+	int backpressure_policy = 0;
 	list<Filter*>::const_iterator it;
 
 	for ( it = stream->filters.begin(); it != stream->filters.end(); ++it )
@@ -1196,6 +1204,8 @@ WriterFrontend* Manager::CreateWriter(EnumVal* id, EnumVal* writer, WriterBacken
 			found_filter_match = true;
 			winfo->interval = f->interval;
 			winfo->postprocessor = f->postprocessor;
+			max_queued_rows = f->max_queued_rows;
+			backpressure_policy = f->backpressure_policy;
 
 			if ( f->postprocessor )
 				{
@@ -1213,6 +1223,14 @@ WriterFrontend* Manager::CreateWriter(EnumVal* id, EnumVal* writer, WriterBacken
 		assert(id);
 		winfo->interval = id->GetVal()->AsInterval();
 
+		// This is the case for writes coming in from remote, so apply
+		// the default queue limits to those as well.
+		static auto default_max_queued_rows = id::find_val("Log::default_max_queued_rows");
+		static auto default_backpressure_policy = id::find_val(
+			"Log::default_backpressure_policy");
+		max_queued_rows = default_max_queued_rows->AsCount();
+		backpressure_policy = default_backpressure_policy->AsEnum();
+
 		if ( winfo->info->post_proc_func && strlen(winfo->info->post_proc_func) )
 			{
 			auto func = id::find_func(winfo->info->post_proc_func);
@@ -1237,6 +1255,7 @@ WriterFrontend* Manager::CreateWriter(EnumVal* id, EnumVal* writer, WriterBacken
 	winfo->info->rotation_base = util::detail::parse_rotate_base_time(base_time);
 
 	winfo->writer = new WriterFrontend(*winfo->info, id, writer, local, remote);
+	winfo->writer->SetBackpressure(max_queued_rows, backpressure_policy);
 	winfo->writer->Init(num_fields, fields);
 
 	if ( ! from_remote )
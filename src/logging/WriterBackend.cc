@@ -3,6 +3,8 @@
 #include "zeek/logging/WriterBackend.h"
 
 #include <broker/data.hh>
+#include <algorithm>
+#include <chrono>
 
 #include "zeek/logging/Manager.h"
 #include "zeek/logging/WriterFrontend.h"
@@ -174,6 +176,63 @@ void WriterBackend::DeleteVals(int num_writes, Value*** vals)
 	delete[] vals;
 	}
 
+void WriterBackend::AddQueuedRows(uint64_t n)
+	{
+	std::lock_guard<std::mutex> lock(queue_mutex);
+	queued_batches.push_back({n, 0});
+	queued_rows.fetch_add(n, std::memory_order_relaxed);
+	}
+
+uint64_t WriterBackend::ShedQueuedRows(uint64_t n)
+	{
+	std::lock_guard<std::mutex> lock(queue_mutex);
+	uint64_t shed = 0;
+
+	for ( auto& b : queued_batches )
+		{
+		if ( shed == n )
+			break;
+
+		auto k = std::min(n - shed, b.rows - b.shed);
+		b.shed += k;
+		shed += k;
+		}
+
+	rows_to_shed.fetch_add(shed, std::memory_order_relaxed);
+	return shed;
+	}
+
+uint64_t WriterBackend::StartQueuedBatch()
+	{
+	std::lock_guard<std::mutex> lock(queue_mutex);
+
+	if ( queued_batches.empty() )
+		return 0;
+
+	auto shed = queued_batches.front().shed;
+	queued_batches.pop_front();
+	rows_to_shed.fetch_sub(shed, std::memory_order_relaxed);
+	return shed;
+	}
+
+void WriterBackend::RowsProcessed(uint64_t n)
+	{
+	queued_rows.fetch_sub(n, std::memory_order_relaxed);
+
+	// Take the lock so a frontend about to wait can't miss the wakeup.
+	std::lock_guard<std::mutex> lock(queue_mutex);
+	queue_drained.notify_all();
+	}
+
+bool WriterBackend::WaitForQueuedRows(uint64_t limit, double timeout)
+	{
+	std::unique_lock<std::mutex> lock(queue_mutex);
+	auto duration = std::chrono::duration<double>(timeout);
+
+	return queue_drained.wait_for(lock, duration,
+	                              [this, limit] { return QueuedRows() < limit; });
+	}
+
 bool WriterBackend::FinishedRotation(const char* new_name, const char* old_name, double open,
                                      double close, bool terminating)
 	{
@@ -213,8 +272,13 @@ bool WriterBackend::Init(int arg_num_fields, const Field* const* arg_fields)
 	return true;
 	}
 
-bool WriterBackend::Write(int arg_num_fields, int num_writes, Value*** vals)
+bool WriterBackend::Write(int arg_num_fields, int num_writes, Value*** vals, bool queued)
 	{
+	// The oldest queued rows may have been dropped by the frontend to
+	// relieve backpressure, skip those. Claim the batch before anything
+	// else so that shedding can't carry over to the next one.
+	int first = queued ? StartQueuedBatch() : 0;
+
 	// Double-check that the arguments match. If we get this from remote,
 	// something might be mixed up.
 	if ( num_fields != arg_num_fields )
@@ -227,6 +291,10 @@ bool WriterBackend::Write(int arg_num_fields, int num_writes, Value*** vals)
 #endif
 
 		DeleteVals(num_writes, vals);
+
+		if ( queued )
+			RowsProcessed(num_writes);
+
 		DisableFrontend();
 		return false;
 		}
@@ -246,6 +314,10 @@ bool WriterBackend::Write(int arg_num_fields, int num_writes, Value*** vals)
 #endif
 				DisableFrontend();
 				DeleteVals(num_writes, vals);
+
+				if ( queued )
+					RowsProcessed(num_writes);
+
 				return false;
 				}
 			}
@@ -255,7 +327,7 @@ bool WriterBackend::Write(int arg_num_fields, int num_writes, Value*** vals)
 
 	if ( ! Failed() )
 		{
-		for ( int j = 0; j < num_writes; j++ )
+		for ( int j = first; j < num_writes; j++ )
 			{
 			success = DoWrite(num_fields, fields, vals[j]);
 
@@ -266,6 +338,9 @@ bool WriterBackend::Write(int arg_num_fields, int num_writes, Value*** vals)
 
 	DeleteVals(num_writes, vals);
 
+	if ( queued )
+		RowsProcessed(num_writes);
+
 	if ( ! success )
 		DisableFrontend();
 
@@ -4,6 +4,11 @@
 
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
 #include "zeek/logging/Component.h"
 #include "zeek/threading/MsgThread.h"
 
@@ -158,12 +163,15 @@ public:
 	 * types musst match with the field passed to Init(). The method
 	 * takes ownership of \a vals..
 	 *
+	 * @param queued Whether the frontend accounted for the rows through
+	 * AddQueuedRows().
+	 *
 	 * Returns false if an error occured, in which case the writer must
 	 * not be used any further.
 	 *
 	 * @return False if an error occured.
 	 */
-	bool Write(int num_fields, int num_writes, threading::Value*** vals);
+	bool Write(int num_fields, int num_writes, threading::Value*** vals, bool queued = false);
 
 	/**
 	 * Sets the buffering status for the writer, assuming the writer
@@ -194,6 +202,52 @@ public:
 	 */
 	bool Rotate(const char* rotated_path, double open, double close, bool terminating);
 
+	/**
+	 * Returns the number of rows passed to Write() messages that the
+	 * backend has not processed yet, not counting rows marked for
+	 * discarding through ShedQueuedRows().
+	 *
+	 * This method is safe to call from any thread.
+	 */
+	uint64_t QueuedRows() const
+		{
+		uint64_t queued = queued_rows.load(std::memory_order_relaxed);
+		uint64_t shed = rows_to_shed.load(std::memory_order_relaxed);
+		return queued > shed ? queued - shed : 0;
+		}
+
+	/**
+	 * Accounts for a Write() message carrying \a n rows that the frontend
+	 * is about to send. Calls must happen in the order the messages are
+	 * sent.
+	 *
+	 * This method must only be called from the main thread.
+	 */
+	void AddQueuedRows(uint64_t n);
+
+	/**
+	 * Asks the backend to discard up to \a n of the oldest queued rows
+	 * instead of writing them out. This implements dropping the oldest
+	 * rows when the writer can't keep up. Only rows of Write() messages
+	 * that the backend hasn't started processing yet can be discarded.
+	 *
+	 * This method must only be called from the main thread.
+	 *
+	 * @return The number of rows marked for discarding, which is less
+	 * than \a n if not enough such rows remain queued.
+	 */
+	uint64_t ShedQueuedRows(uint64_t n);
+
+	/**
+	 * Blocks until fewer than \a limit rows remain queued, as returned by
+	 * QueuedRows(), or until \a timeout seconds have passed.
+	 *
+	 * This method must only be called from the main thread.
+	 *
+	 * @return True if the queue is now below the limit.
+	 */
+	bool WaitForQueuedRows(uint64_t limit, double timeout);
+
 	/**
 	 * Disables the frontend that has instantiated this backend. Once
 	 * disabled,the frontend will not send any further message over.
@@ -391,6 +445,19 @@ private:
 	 */
 	void DeleteVals(int num_writes, threading::Value*** vals);
 
+	/**
+	 * Removes the oldest Write() message from the accounting of those
+	 * queued, as the backend is starting on it, and returns how many of
+	 * its leading rows to discard, as requested through ShedQueuedRows().
+	 */
+	uint64_t StartQueuedBatch();
+
+	/**
+	 * Marks \a n queued rows as processed and wakes up a main thread
+	 * blocked in WaitForQueuedRows().
+	 */
+	void RowsProcessed(uint64_t n);
+
 	// Frontend that instantiated us. This object must not be access from
 	// this class, it's running in a different thread!
 	WriterFrontend* frontend;
@@ -401,6 +468,23 @@ private:
 	bool buffering; // True if buffering is enabled.
 
 	int rotation_counter; // Tracks FinishedRotation() calls.
+
+	// A Write() message's rows, and how many of them to discard.
+	struct QueuedBatch
+		{
+		uint64_t rows;
+		uint64_t shed;
+		};
+
+	// Accounting of rows queued between frontend and backend, shared
+	// between the main thread and this one. The batches are those the
+	// backend hasn't started on, in the order they were sent, and are
+	// guarded by the mutex.
+	std::atomic<uint64_t> queued_rows = 0;
+	std::atomic<uint64_t> rows_to_shed = 0;
+	std::deque<QueuedBatch> queued_batches;
+	std::mutex queue_mutex;
+	std::condition_variable queue_drained;
 	};
 
 	} // namespace zeek::logging
@@ -1,9 +1,17 @@
 #include "zeek/logging/WriterFrontend.h"
 
+#include <unistd.h>
+#include <cerrno>
+#include <cinttypes>
+#include <cstring>
+
 #include "zeek/RunState.h"
+#include "zeek/SerializationFormat.h"
 #include "zeek/broker/Manager.h"
 #include "zeek/logging/Manager.h"
 #include "zeek/logging/WriterBackend.h"
+#include "zeek/logging/logging.bif.h"
+#include "zeek/telemetry/Manager.h"
 #include "zeek/threading/SerialTypes.h"
 
 using zeek::threading::Field;
@@ -56,18 +64,20 @@ private:
 class WriteMessage final : public threading::InputMessage<WriterBackend>
 	{
 public:
-	WriteMessage(WriterBackend* backend, int num_fields, int num_writes, Value*** vals)
+	WriteMessage(WriterBackend* backend, int num_fields, int num_writes, Value*** vals,
+	             bool queued)
 		: threading::InputMessage<WriterBackend>("Write", backend), num_fields(num_fields),
-		  num_writes(num_writes), vals(vals)
+		  num_writes(num_writes), vals(vals), queued(queued)
 		{
 		}
 
-	bool Process() override { return Object()->Write(num_fields, num_writes, vals); }
+	bool Process() override { return Object()->Write(num_fields, num_writes, vals, queued); }
 
 private:
 	int num_fields;
 	int num_writes;
 	Value*** vals;
+	bool queued;
 	};
 
 class SetBufMessage final : public threading::InputMessage<WriterBackend>
@@ -98,6 +108,157 @@ private:
 	double network_time;
 	};
 
+namespace detail
+	{
+
+/**
+ * A temporary file holding log rows that didn't fit into a writer's queue.
+ * Rows are appended at the end and read back from the front. The file is
+ * unlinked right after creation, so it disappears with the process.
+ */
+class WriteSpill
+	{
+public:
+	static std::unique_ptr<WriteSpill> Create(const std::string& dir, std::string* error)
+		{
+		std::string tmpl = (dir.empty() ? std::string(".") : dir) + "/.zeek-log-spill.XXXXXX";
+		int fd = mkstemp(tmpl.data());
+
+		if ( fd < 0 )
+			{
+			*error = util::fmt("cannot create spill file %s: %s", tmpl.c_str(), strerror(errno));
+			return nullptr;
+			}
+
+		unlink(tmpl.c_str());
+		return std::unique_ptr<WriteSpill>(new WriteSpill(fd));
+		}
+
+	~WriteSpill() { util::safe_close(fd); }
+
+	bool Empty() const { return num_rows == 0; }
+
+	/**
+	 * Appends a row. Takes ownership of the values.
+	 */
+	bool Put(int num_fields, Value** vals)
+		{
+		zeek::detail::BinarySerializationFormat fmt;
+		fmt.StartWrite();
+
+		bool success = true;
+
+		for ( int i = 0; i < num_fields && success; ++i )
+			success = vals[i]->Write(&fmt);
+
+		char* data;
+		uint32_t len = fmt.EndWrite(&data);
+
+		if ( success )
+			{
+			success = util::safe_pwrite(fd, reinterpret_cast<const unsigned char*>(&len),
+			                            sizeof(len), write_offset) &&
+			          util::safe_pwrite(fd, reinterpret_cast<const unsigned char*>(data), len,
+			                            write_offset + sizeof(len));
+			}
+
+		free(data);
+
+		for ( int i = 0; i < num_fields; ++i )
+			delete vals[i];
+
+		delete[] vals;
+
+		if ( ! success )
+			return false;
+
+		write_offset += sizeof(len) + len;
+		++num_rows;
+		return true;
+		}
+
+	/**
+	 * Removes the oldest row and returns it, or null if reading it back
+	 * failed. Must not be called when empty.
+	 */
+	Value** Get(int num_fields)
+		{
+		uint32_t len;
+
+		// A row that can't be read back counts as consumed.
+		if ( pread(fd, &len, sizeof(len), read_offset) != sizeof(len) )
+			{
+			--num_rows;
+			return nullptr;
+			}
+
+		std::string data(len, '\0');
+
+		if ( pread(fd, data.data(), len, read_offset + sizeof(len)) !=
+		     static_cast<ssize_t>(len) )
+			{
+			--num_rows;
+			return nullptr;
+			}
+
+		read_offset += sizeof(len) + len;
+
+		if ( --num_rows == 0 )
+			Clear();
+
+		// A damaged file must not abort, the caller drops what's left.
+		zeek::detail::BinarySerializationFormat fmt;
+		fmt.SetQuiet();
+		fmt.StartRead(data.data(), len);
+
+		auto vals = new Value*[num_fields];
+
+		for ( int i = 0; i < num_fields; ++i )
+			{
+			vals[i] = new Value;
+
+			if ( ! vals[i]->Read(&fmt) )
+				{
+				for ( int j = 0; j <= i; ++j )
+					delete vals[j];
+
+				delete[] vals;
+				return nullptr;
+				}
+			}
+
+		fmt.EndRead();
+		return vals;
+		}
+
+	/**
+	 * Discards all rows and returns how many there were.
+	 */
+	uint64_t Clear()
+		{
+		uint64_t n = num_rows;
+		num_rows = 0;
+
+		// Start over at the beginning to give back the space.
+		read_offset = write_offset = 0;
+
+		if ( ftruncate(fd, 0) < 0 )
+			reporter->Warning("cannot truncate log spill file: %s", strerror(errno));
+
+		return n;
+		}
+
+private:
+	explicit WriteSpill(int arg_fd) : fd(arg_fd) { }
+
+	int fd;
+	size_t read_offset = 0;
+	size_t write_offset = 0;
+	uint64_t num_rows = 0;
+	};
+
+	} // namespace detail
+
 // Frontend methods.
 
 WriterFrontend::WriterFrontend(const WriterBackend::WriterInfo& arg_info, EnumVal* arg_stream,
@@ -114,6 +275,9 @@ WriterFrontend::WriterFrontend(const WriterBackend::WriterInfo& arg_info, EnumVa
 	remote = arg_remote;
 	write_buffer = nullptr;
 	write_buffer_pos = 0;
+	max_queued_rows = 0;
+	backpressure_policy = BifEnum::Log::BACKPRESSURE_BLOCK;
+	reported_queued_rows = 0;
 	info = new WriterBackend::WriterInfo(arg_info);
 
 	num_fields = 0;
@@ -149,6 +313,10 @@ WriterFrontend::~WriterFrontend()
 
 void WriterFrontend::Stop()
 	{
+	// Don't lose spilled rows, queue them regardless of the limit.
+	if ( spill )
+		ReplaySpill(true);
+
 	FlushWriteBuffer();
 	SetDisable();
 
@@ -215,6 +383,14 @@ void WriterFrontend::Write(int arg_num_fields, Value** vals)
 		return;
 		}
 
+	if ( max_queued_rows && ! ApplyBackpressure(vals) )
+		return;
+
+	BufferWrite(vals);
+	}
+
+void WriterFrontend::BufferWrite(Value** vals)
+	{
 	if ( ! write_buffer )
 		{
 		// Need new buffer.
@@ -226,21 +402,215 @@ void WriterFrontend::Write(int arg_num_fields, Value** vals)
 
 	if ( write_buffer_pos >= WRITER_BUFFER_SIZE || ! buf || run_state::terminating )
 		// Buffer full (or no bufferin desired or termiating).
-		FlushWriteBuffer();
+		SendWriteBuffer();
 	}
 
 void WriterFrontend::FlushWriteBuffer()
+	{
+	// The backend triggers this at every heartbeat, which is a good time
+	// to check whether it has made room for spilled rows.
+	if ( spill && ! spill->Empty() )
+		ReplaySpill(run_state::terminating);
+
+	SendWriteBuffer();
+	}
+
+void WriterFrontend::SendWriteBuffer()
 	{
 	if ( ! write_buffer_pos )
 		// Nothing to do.
 		return;
 
 	if ( backend )
-		backend->SendIn(new WriteMessage(backend, num_fields, write_buffer_pos, write_buffer));
+		{
+		// Only bounded queues need their rows accounted for.
+		bool queued = max_queued_rows > 0;
+
+		if ( queued )
+			backend->AddQueuedRows(write_buffer_pos);
+
+		backend->SendIn(
+			new WriteMessage(backend, num_fields, write_buffer_pos, write_buffer, queued));
+		}
 
 	// Clear buffer (no delete, we pass ownership to child thread.)
 	write_buffer = nullptr;
 	write_buffer_pos = 0;
+
+	UpdateQueuedRowsMetric();
+	}
+
+void WriterFrontend::UpdateQueuedRowsMetric()
+	{
+	if ( ! metrics )
+		return;
+
+	int64_t queued = QueuedRows();
+	metrics->queued_rows.Inc(queued - reported_queued_rows);
+	reported_queued_rows = queued;
+	}
+
+void WriterFrontend::SetBackpressure(uint64_t arg_max_queued_rows, int policy)
+	{
+	max_queued_rows = arg_max_queued_rows;
+	backpressure_policy = policy;
+
+	if ( ! max_queued_rows || metrics )
+		return;
+
+	auto queued_family = telemetry_mgr->GaugeFamily("zeek", "log-writer-queued-rows", {"writer"},
+	                                                "Rows queued for log writer threads");
+	auto dropped_family = telemetry_mgr->CounterFamily(
+		"zeek", "log-writer-dropped-rows", {"writer"},
+		"Log rows dropped because a writer's queue was full", "1", true);
+	auto spilled_family = telemetry_mgr->CounterFamily(
+		"zeek", "log-writer-spilled-rows", {"writer"},
+		"Log rows spilled to disk because a writer's queue was full", "1", true);
+
+	// Buckets range from 100us to 10s.
+	static const double latency_bounds[] = {0.0001, 0.001, 0.01, 0.1, 1.0, 10.0};
+	auto latency_family = telemetry_mgr->HistogramFamily<double>(
+		"zeek", "log-writer-enqueue-latency", {"writer"}, latency_bounds,
+		"Time log writes spent blocked on a full writer queue", "seconds");
+
+	metrics = Metrics{queued_family.GetOrAdd({{"writer", name}}),
+	                  dropped_family.GetOrAdd({{"writer", name}}),
+	                  spilled_family.GetOrAdd({{"writer", name}}),
+	                  latency_family.GetOrAdd({{"writer", name}})};
+	}
+
+uint64_t WriterFrontend::QueuedRows() const
+	{
+	return (backend ? backend->QueuedRows() : 0) + write_buffer_pos;
+	}
+
+bool WriterFrontend::ApplyBackpressure(Value** vals)
+	{
+	if ( spill && ! spill->Empty() )
+		{
+		// Rows must not overtake those already spilled.
+		ReplaySpill();
+
+		if ( ! spill->Empty() )
+			{
+			if ( ! spill->Put(num_fields, vals) )
+				{
+				reporter->Error("failed to spill log row for %s, dropping it", name);
+				metrics->dropped_rows.Inc();
+				return false;
+				}
+
+			metrics->spilled_rows.Inc();
+			return false;
+			}
+		}
+
+	if ( QueuedRows() < max_queued_rows )
+		return true;
+
+	switch ( backpressure_policy )
+		{
+		case BifEnum::Log::BACKPRESSURE_BLOCK:
+			WaitForQueue();
+			return true;
+
+		case BifEnum::Log::BACKPRESSURE_DROP_OLDEST:
+			metrics->dropped_rows.Inc();
+
+			// Prefer dropping from what the backend has yet to start on,
+			// as that's older than anything in our buffer.
+			if ( backend->ShedQueuedRows(1) )
+				{
+				UpdateQueuedRowsMetric();
+				return true;
+				}
+
+			if ( write_buffer_pos > 0 )
+				{
+				DeleteVals(num_fields, write_buffer[0]);
+				memmove(write_buffer, write_buffer + 1, (write_buffer_pos - 1) * sizeof(Value**));
+				--write_buffer_pos;
+				UpdateQueuedRowsMetric();
+				return true;
+				}
+
+			// All that's queued is what the backend is busy writing, so
+			// the new row is the oldest one left to drop.
+			DeleteVals(num_fields, vals);
+			return false;
+
+		case BifEnum::Log::BACKPRESSURE_DROP_NEWEST:
+			DeleteVals(num_fields, vals);
+			metrics->dropped_rows.Inc();
+			return false;
+
+		case BifEnum::Log::BACKPRESSURE_SPILL:
+			{
+			if ( ! spill )
+				{
+				static auto spill_dir = id::find_val<StringVal>("Log::spill_dir");
+				std::string error;
+				spill = detail::WriteSpill::Create(spill_dir->ToStdString(), &error);
+
+				if ( ! spill )
+					{
+					reporter->Error("%s, blocking writes to %s instead", error.c_str(), name);
+					backpressure_policy = BifEnum::Log::BACKPRESSURE_BLOCK;
+					WaitForQueue();
+					return true;
+					}
+				}
+
+			if ( ! spill->Put(num_fields, vals) )
+				{
+				reporter->Error("failed to spill log row for %s, dropping it", name);
+				metrics->dropped_rows.Inc();
+				return false;
+				}
+
+			metrics->spilled_rows.Inc();
+			return false;
+			}
+
+		default:
+			reporter->InternalWarning("unknown log backpressure policy %d", backpressure_policy);
+			return true;
+		}
+	}
+
+void WriterFrontend::WaitForQueue()
+	{
+	double start = util::current_time();
+
+	// Send over what's buffered so that the limit only applies to the
+	// backend's queue, which it can actually drain.
+	SendWriteBuffer();
+
+	while ( backend && ! backend->Killed() && ! backend->Terminating() &&
+	        ! backend->WaitForQueuedRows(max_queued_rows, 0.1) )
+		;
+
+	metrics->enqueue_latency.Observe(util::current_time() - start);
+	}
+
+void WriterFrontend::ReplaySpill(bool ignore_limit)
+	{
+	while ( ! spill->Empty() && (ignore_limit || QueuedRows() < max_queued_rows) )
+		{
+		auto vals = spill->Get(num_fields);
+
+		if ( ! vals )
+			{
+			// Can't trust the rest of the file anymore either.
+			auto lost = spill->Clear() + 1;
+			reporter->Error("failed to read back spilled log rows for %s, dropped %" PRIu64,
+			                name, lost);
+			metrics->dropped_rows.Inc(lost);
+			break;
+			}
+
+		BufferWrite(vals);
+		}
 	}
 
 void WriterFrontend::SetBuf(bool enabled)
@@ -2,13 +2,24 @@
 
 #pragma once
 
+#include <memory>
+#include <optional>
+
 #include "zeek/logging/WriterBackend.h"
+#include "zeek/telemetry/Counter.h"
+#include "zeek/telemetry/Gauge.h"
+#include "zeek/telemetry/Histogram.h"
 
 namespace zeek::logging
 	{
 
 class Manager;
 
+namespace detail
+	{
+class WriteSpill;
+	}
+
 /**
  * Bridge class between the logging::Manager and backend writer threads. The
  * Manager instantiates one \a WriterFrontend for each open logging filter.
@@ -143,6 +154,19 @@ public:
 	 */
 	void FlushWriteBuffer();
 
+	/**
+	 * Bounds the number of rows queued for the backend thread.
+	 *
+	 * max_queued_rows: The maximum number of rows written but not yet
+	 * processed by the backend. Zero means unbounded.
+	 *
+	 * policy: The script-level \c Log::BackpressurePolicy value that
+	 * determines what Write() does once the limit is reached.
+	 *
+	 * This method must only be called from the main thread.
+	 */
+	void SetBackpressure(uint64_t max_queued_rows, int policy);
+
 	/**
 	 * Disables the writer frontend. From now on, all method calls that
 	 * would normally send message over to the backend, turn into no-ops.
@@ -190,6 +214,31 @@ protected:
 
 	void DeleteVals(int num_fields, threading::Value** vals);
 
+	// Returns the number of rows queued for the backend, including those
+	// still in the write buffer.
+	uint64_t QueuedRows() const;
+
+	// Brings the queued rows gauge up to date.
+	void UpdateQueuedRowsMetric();
+
+	// Applies the backpressure policy to a row about to be queued.
+	// Returns false if the row was dropped or spilled, in which case
+	// ownership of vals has been taken.
+	bool ApplyBackpressure(threading::Value** vals);
+
+	// Blocks until the backend's queue has room.
+	void WaitForQueue();
+
+	// Moves spilled rows back into the queue as long as it has room, or
+	// all of them if ignore_limit is set.
+	void ReplaySpill(bool ignore_limit = false);
+
+	// Adds a row to the write buffer, sending it over once full.
+	void BufferWrite(threading::Value** vals);
+
+	// Sends the write buffer's rows over to the backend.
+	void SendWriteBuffer();
+
 	EnumVal* stream;
 	EnumVal* writer;
 
@@ -209,6 +258,22 @@ protected:
 	static const int WRITER_BUFFER_SIZE = 1000;
 	int write_buffer_pos; // Position of next write in buffer.
 	threading::Value*** write_buffer; // Buffer of size WRITER_BUFFER_SIZE.
+
+	// Backpressure settings and state.
+	uint64_t max_queued_rows; // Zero if unbounded.
+	int backpressure_policy; // A BifEnum::Log::BackpressurePolicy.
+	std::unique_ptr<detail::WriteSpill> spill;
+
+	struct Metrics
+		{
+		telemetry::IntGauge queued_rows;
+		telemetry::IntCounter dropped_rows;
+		telemetry::IntCounter spilled_rows;
+		telemetry::DblHistogram enqueue_latency;
+		};
+
+	std::optional<Metrics> metrics; // Set if the queue is bounded.
+	int64_t reported_queued_rows; // Last value passed to the gauge.
 	};
 
 	} // namespace zeek::logging
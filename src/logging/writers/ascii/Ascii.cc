@@ -201,6 +201,10 @@ Ascii::Ascii(WriterFrontend* frontend) : WriterBackend(frontend)
 	formatter = nullptr;
 	gzip_level = 0;
 	gzfile = nullptr;
+	zstd_level = 0;
+	lz4_level = 0;
+	compression_threads = 0;
+	compression_block_size = 0;
 
 	InitConfigOptions();
 	init_options = InitFilterOptions();
@@ -213,6 +217,10 @@ void Ascii::InitConfigOptions()
 	use_json = BifConst::LogAscii::use_json;
 	enable_utf_8 = BifConst::LogAscii::enable_utf_8;
 	gzip_level = BifConst::LogAscii::gzip_level;
+	zstd_level = BifConst::LogAscii::zstd_level;
+	lz4_level = BifConst::LogAscii::lz4_level;
+	compression_threads = BifConst::LogAscii::compression_threads;
+	compression_block_size = BifConst::LogAscii::compression_block_size;
 
 	separator.assign((const char*)BifConst::LogAscii::separator->Bytes(),
 	                 BifConst::LogAscii::separator->Len());
@@ -238,6 +246,12 @@ void Ascii::InitConfigOptions()
 	gzip_file_extension.assign((const char*)BifConst::LogAscii::gzip_file_extension->Bytes(),
 	                           BifConst::LogAscii::gzip_file_extension->Len());
 
+	zstd_file_extension.assign((const char*)BifConst::LogAscii::zstd_file_extension->Bytes(),
+	                           BifConst::LogAscii::zstd_file_extension->Len());
+
+	lz4_file_extension.assign((const char*)BifConst::LogAscii::lz4_file_extension->Bytes(),
+	                          BifConst::LogAscii::lz4_file_extension->Len());
+
 	logdir.assign((const char*)BifConst::LogAscii::logdir->Bytes(),
 	              BifConst::LogAscii::logdir->Len());
 	}
@@ -273,6 +287,37 @@ bool Ascii::InitFilterOptions()
 				return false;
 				}
 			}
+
+		else if ( strcmp(i->first, "zstd_level") == 0 )
+			zstd_level = atoi(i->second);
+
+		else if ( strcmp(i->first, "lz4_level") == 0 )
+			lz4_level = atoi(i->second);
+
+		else if ( strcmp(i->first, "compression_threads") == 0 )
+			{
+			compression_threads = atoi(i->second);
+
+			if ( compression_threads < 0 )
+				{
+				Error("invalid value for 'compression_threads', must be a non-negative number.");
+				return false;
+				}
+			}
+
+		else if ( strcmp(i->first, "compression_block_size") == 0 )
+			{
+			int size = atoi(i->second);
+
+			if ( size <= 0 )
+				{
+				Error("invalid value for 'compression_block_size', must be a positive number.");
+				return false;
+				}
+
+			compression_block_size = size;
+			}
+
 		else if ( strcmp(i->first, "use_json") == 0 )
 			{
 			if ( strcmp(i->second, "T") == 0 )
@@ -349,16 +394,105 @@ bool Ascii::InitFilterOptions()
 		else if ( strcmp(i->first, "gzip_file_extension") == 0 )
 			gzip_file_extension.assign(i->second);
 
+		else if ( strcmp(i->first, "zstd_file_extension") == 0 )
+			zstd_file_extension.assign(i->second);
+
+		else if ( strcmp(i->first, "lz4_file_extension") == 0 )
+			lz4_file_extension.assign(i->second);
+
 		else if ( strcmp(i->first, "logdir") == 0 )
 			logdir.assign(i->second);
 		}
 
+	if ( ! InitCompression() )
+		return false;
+
 	if ( ! InitFormatter() )
 		return false;
 
 	return true;
 	}
 
+bool Ascii::InitCompression()
+	{
+	compressor.reset();
+
+	int enabled = (gzip_level > 0) + (zstd_level > 0) + (lz4_level > 0);
+
+	if ( enabled > 1 )
+		{
+		Error("only one of 'gzip_level', 'zstd_level' and 'lz4_level' may be enabled");
+		return false;
+		}
+
+	BlockCompressor::Method method;
+	int level;
+
+	if ( zstd_level > 0 )
+		{
+		method = BlockCompressor::ZSTD;
+		level = zstd_level;
+		}
+	else if ( lz4_level > 0 )
+		{
+		method = BlockCompressor::LZ4;
+		level = lz4_level;
+		}
+	else
+		return true;
+
+	const char* name = BlockCompressor::MethodName(method);
+
+	if ( ! BlockCompressor::Available(method) )
+		{
+		Error(Fmt("%s compression requested, but Zeek was built without %s support", name, name));
+		return false;
+		}
+
+	if ( level < BlockCompressor::MinLevel(method) || level > BlockCompressor::MaxLevel(method) )
+		{
+		Error(Fmt("invalid value for '%s_level', must be a number between 0 and %d.", name,
+		          BlockCompressor::MaxLevel(method)));
+		return false;
+		}
+
+	if ( compression_block_size == 0 )
+		{
+		Error("invalid value for 'compression_block_size', must be a positive number.");
+		return false;
+		}
+
+	compressor = std::make_unique<BlockCompressor>(method, level, compression_threads,
+	                                               compression_block_size);
+	return true;
+	}
+
+std::string Ascii::CompressionExtension() const
+	{
+	const std::string* ext = nullptr;
+	const char* def = nullptr;
+
+	if ( gzip_level > 0 )
+		{
+		ext = &gzip_file_extension;
+		def = "gz";
+		}
+	else if ( zstd_level > 0 )
+		{
+		ext = &zstd_file_extension;
+		def = "zst";
+		}
+	else if ( lz4_level > 0 )
+		{
+		ext = &lz4_file_extension;
+		def = "lz4";
+		}
+	else
+		return "";
+
+	return "." + (ext->empty() ? std::string(def) : *ext);
+	}
+
 bool Ascii::InitFormatter()
 	{
 	delete formatter;
@@ -448,13 +582,7 @@ bool Ascii::DoInit(const WriterInfo& info, int num_fields, const threading::Fiel
 
 	if ( ! IsSpecial(fname) )
 		{
-		std::string ext = "." + LogExt();
-
-		if ( gzip_level > 0 )
-			{
-			ext += ".";
-			ext += gzip_file_extension.empty() ? "gz" : gzip_file_extension;
-			}
+		std::string ext = "." + LogExt() + CompressionExtension();
 
 		if ( fname.front() != '/' && ! logdir.empty() )
 			{
@@ -543,6 +671,9 @@ bool Ascii::DoInit(const WriterInfo& info, int num_fields, const threading::Fiel
 		gzfile = nullptr;
 		}
 
+	if ( compressor )
+		compressor->Open(fd);
+
 	if ( ! WriteHeader(path) )
 		{
 		Error(Fmt("error writing to %s: %s", fname.c_str(), Strerror(errno)));
@@ -603,6 +734,12 @@ bool Ascii::WriteHeader(const string& path)
 
 bool Ascii::DoFlush(double network_time)
 	{
+	if ( compressor && fd && ! compressor->Flush() )
+		{
+		Error(Fmt("error flushing %s: %s", fname.c_str(), compressor->Error().c_str()));
+		return false;
+		}
+
 	fsync(fd);
 	return true;
 	}
@@ -676,13 +813,7 @@ bool Ascii::DoRotate(const char* rotated_path, double open, double close, bool t
 
 	CloseFile(close);
 
-	string nname = string(rotated_path) + "." + LogExt();
-
-	if ( gzip_level > 0 )
-		{
-		nname += ".";
-		nname += gzip_file_extension.empty() ? "gz" : gzip_file_extension;
-		}
+	string nname = string(rotated_path) + "." + LogExt() + CompressionExtension();
 
 	if ( rename(fname.c_str(), nname.c_str()) != 0 )
 		{
@@ -899,6 +1030,15 @@ string Ascii::Timestamp(double t)
 
 bool Ascii::InternalWrite(int fd, const char* data, int len)
 	{
+	if ( compressor )
+		{
+		if ( compressor->Write(data, len) )
+			return true;
+
+		Error(Fmt("Ascii::InternalWrite error: %s", compressor->Error().c_str()));
+		return false;
+		}
+
 	if ( ! gzfile )
 		return util::safe_write(fd, data, len);
 
@@ -922,6 +1062,17 @@ bool Ascii::InternalWrite(int fd, const char* data, int len)
 
 bool Ascii::InternalClose(int fd)
 	{
+	if ( compressor )
+		{
+		bool ok = compressor->Close();
+		util::safe_close(fd);
+
+		if ( ! ok )
+			Error(Fmt("Ascii::InternalClose error: %s", compressor->Error().c_str()));
+
+		return ok;
+		}
+
 	if ( ! gzfile )
 		{
 		util::safe_close(fd);
@@ -8,6 +8,7 @@
 
 #include "zeek/Desc.h"
 #include "zeek/logging/WriterBackend.h"
+#include "zeek/logging/writers/ascii/BlockCompressor.h"
 #include "zeek/threading/formatters/Ascii.h"
 #include "zeek/threading/formatters/JSON.h"
 
@@ -53,11 +54,14 @@ private:
 	void InitConfigOptions();
 	bool InitFilterOptions();
 	bool InitFormatter();
+	bool InitCompression();
+	std::string CompressionExtension() const;
 	bool InternalWrite(int fd, const char* data, int len);
 	bool InternalClose(int fd);
 
 	int fd;
 	gzFile gzfile;
+	std::unique_ptr<BlockCompressor> compressor;
 	std::string fname;
 	ODesc desc;
 	bool ascii_done;
@@ -75,6 +79,12 @@ private:
 
 	int gzip_level; // level > 0 enables gzip compression
 	std::string gzip_file_extension;
+	int zstd_level; // level > 0 enables zstd compression
+	std::string zstd_file_extension;
+	int lz4_level; // level > 0 enables lz4 compression
+	std::string lz4_file_extension;
+	int compression_threads;
+	size_t compression_block_size;
 	bool use_json;
 	bool enable_utf_8;
 	std::string json_timestamps;
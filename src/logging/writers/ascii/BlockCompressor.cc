@@ -0,0 +1,316 @@
+// See the file "COPYING" in the main distribution directory for copyright.
+
+#include "zeek/logging/writers/ascii/BlockCompressor.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#ifdef USE_ZSTD
+#include <zstd.h>
+#endif
+
+#ifdef USE_LZ4
+#include <lz4frame.h>
+#endif
+
+#include "zeek/util.h"
+
+namespace zeek::logging::writer::detail
+	{
+
+bool BlockCompressor::Available(Method method)
+	{
+	switch ( method )
+		{
+		case ZSTD:
+#ifdef USE_ZSTD
+			return true;
+#else
+			return false;
+#endif
+
+		case LZ4:
+#ifdef USE_LZ4
+			return true;
+#else
+			return false;
+#endif
+		}
+
+	return false;
+	}
+
+const char* BlockCompressor::MethodName(Method method)
+	{
+	switch ( method )
+		{
+		case ZSTD:
+			return "zstd";
+		case LZ4:
+			return "lz4";
+		}
+
+	return "<unknown>";
+	}
+
+int BlockCompressor::MinLevel(Method method)
+	{
+	return 1;
+	}
+
+int BlockCompressor::MaxLevel(Method method)
+	{
+	switch ( method )
+		{
+		case ZSTD:
+#ifdef USE_ZSTD
+			return ZSTD_maxCLevel();
+#else
+			return 22;
+#endif
+
+		case LZ4:
+			// Levels above 2 select LZ4's high-compression mode.
+			return 12;
+		}
+
+	return 1;
+	}
+
+BlockCompressor::BlockCompressor(Method arg_method, int arg_level, int num_threads,
+                                 size_t arg_block_size)
+	: method(arg_method), level(arg_level), block_size(arg_block_size)
+	{
+	if ( block_size == 0 )
+		block_size = 1;
+
+	// Bound the number of blocks in flight so that a slow disk or slow
+	// compression cannot make memory grow without limit. Beyond this the
+	// writer thread waits for the oldest frame.
+	max_pending = num_threads > 0 ? 2 * num_threads : 0;
+
+	block.reserve(block_size);
+
+	for ( int i = 0; i < num_threads; ++i )
+		workers.emplace_back(&BlockCompressor::Worker, this);
+	}
+
+BlockCompressor::~BlockCompressor()
+	{
+		{
+		std::lock_guard<std::mutex> lock(mtx);
+		terminating = true;
+		todo.clear();
+		}
+
+	has_work.notify_all();
+
+	for ( auto& t : workers )
+		t.join();
+	}
+
+void BlockCompressor::Open(int arg_fd)
+	{
+	fd = arg_fd;
+	block.clear();
+	error.clear();
+	}
+
+bool BlockCompressor::Write(const char* data, size_t len)
+	{
+	while ( len > 0 )
+		{
+		size_t n = std::min(len, block_size - block.size());
+		block.append(data, n);
+		data += n;
+		len -= n;
+
+		if ( block.size() == block_size && ! Submit() )
+			return false;
+		}
+
+	return true;
+	}
+
+bool BlockCompressor::Flush()
+	{
+	if ( ! block.empty() && ! Submit() )
+		return false;
+
+	return WriteFrames(0);
+	}
+
+bool BlockCompressor::Close()
+	{
+	bool rval = Flush();
+	fd = -1;
+	return rval;
+	}
+
+bool BlockCompressor::Submit()
+	{
+	auto job = std::make_shared<Job>();
+	job->input.swap(block);
+	block.reserve(block_size);
+
+	if ( workers.empty() )
+		{
+		Compress(job.get());
+		return WriteFrame(*job);
+		}
+
+		{
+		std::lock_guard<std::mutex> lock(mtx);
+		todo.push_back(job);
+		pending.push_back(std::move(job));
+		}
+
+	has_work.notify_one();
+
+	return WriteFrames(max_pending);
+	}
+
+bool BlockCompressor::WriteFrames(size_t max_outstanding)
+	{
+	std::unique_lock<std::mutex> lock(mtx);
+
+	while ( ! pending.empty() )
+		{
+		// Only this thread removes from the pending queue, so the
+		// front element stays the same while we wait.
+		const auto& head = pending.front();
+
+		if ( ! head->done )
+			{
+			if ( pending.size() <= max_outstanding )
+				break;
+
+			has_result.wait(lock, [&head] { return head->done; });
+			}
+
+		auto job = std::move(pending.front());
+		pending.pop_front();
+
+		lock.unlock();
+		bool ok = WriteFrame(*job);
+		lock.lock();
+
+		if ( ! ok )
+			return false;
+		}
+
+	return true;
+	}
+
+bool BlockCompressor::WriteFrame(const Job& job)
+	{
+	if ( ! job.error.empty() )
+		{
+		error = std::string(MethodName(method)) + " compression failed: " + job.error;
+		return false;
+		}
+
+	if ( fd < 0 )
+		{
+		error = "no open file to write compressed data to";
+		return false;
+		}
+
+	if ( ! util::safe_write(fd, job.output.data(), job.output.size()) )
+		{
+		char buf[256];
+		util::zeek_strerror_r(errno, buf, sizeof(buf));
+		error = std::string("writing compressed data failed: ") + buf;
+		return false;
+		}
+
+	return true;
+	}
+
+void BlockCompressor::Worker()
+	{
+	std::unique_lock<std::mutex> lock(mtx);
+
+	while ( true )
+		{
+		has_work.wait(lock, [this] { return terminating || ! todo.empty(); });
+
+		if ( terminating )
+			return;
+
+		auto job = std::move(todo.front());
+		todo.pop_front();
+
+		lock.unlock();
+		Compress(job.get());
+		lock.lock();
+
+		job->done = true;
+		has_result.notify_all();
+		}
+	}
+
+void BlockCompressor::Compress(Job* job) const
+	{
+	const auto& in = job->input;
+	auto& out = job->output;
+
+	switch ( method )
+		{
+		case ZSTD:
+			{
+#ifdef USE_ZSTD
+			// Keep one context per thread rather than allocating a
+			// fresh one for every block.
+			thread_local std::unique_ptr<ZSTD_CCtx, decltype(&ZSTD_freeCCtx)>
+				cctx(ZSTD_createCCtx(), &ZSTD_freeCCtx);
+
+			out.resize(ZSTD_compressBound(in.size()));
+			size_t n = ZSTD_compressCCtx(cctx.get(), out.data(), out.size(), in.data(),
+			                             in.size(), level);
+
+			if ( ZSTD_isError(n) )
+				{
+				job->error = ZSTD_getErrorName(n);
+				return;
+				}
+
+			out.resize(n);
+#else
+			job->error = "not supported by this build";
+#endif
+			break;
+			}
+
+		case LZ4:
+			{
+#ifdef USE_LZ4
+			LZ4F_preferences_t prefs;
+			memset(&prefs, 0, sizeof(prefs));
+			prefs.compressionLevel = level;
+			prefs.frameInfo.contentSize = in.size();
+			prefs.frameInfo.contentChecksumFlag = LZ4F_contentChecksumEnabled;
+
+			out.resize(LZ4F_compressFrameBound(in.size(), &prefs));
+			size_t n = LZ4F_compressFrame(out.data(), out.size(), in.data(), in.size(), &prefs);
+
+			if ( LZ4F_isError(n) )
+				{
+				job->error = LZ4F_getErrorName(n);
+				return;
+				}
+
+			out.resize(n);
+#else
+			job->error = "not supported by this build";
+#endif
+			break;
+			}
+		}
+
+	// The input isn't needed anymore, release its memory early.
+	std::string().swap(job->input);
+	}
+
+	} // namespace zeek::logging::writer::detail
@@ -0,0 +1,144 @@
+// See the file "COPYING" in the main distribution directory for copyright.
+//
+// Frame-per-block compression pipeline for the ASCII log writer.
+
+#pragma once
+
+#include "zeek/zeek-config.h"
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace zeek::logging::writer::detail
+	{
+
+/**
+ * Compresses a byte stream into a sequence of independent frames.
+ *
+ * Data is accumulated into blocks of a fixed size. Each full block is
+ * compressed into a self-contained zstd or lz4 frame, optionally by a pool
+ * of background threads, and the frames are written to the output file in
+ * their original order. As concatenated frames form a valid stream for both
+ * formats, a file cut short by a crash remains readable up to its last
+ * completely written frame.
+ *
+ * Apart from its internal worker threads, a compressor must only be used
+ * from a single thread.
+ */
+class BlockCompressor
+	{
+public:
+	enum Method
+		{
+		ZSTD,
+		LZ4,
+		};
+
+	/**
+	 * Returns true if Zeek was built with support for the given method.
+	 */
+	static bool Available(Method method);
+
+	/**
+	 * Returns the name of a method for use in messages.
+	 */
+	static const char* MethodName(Method method);
+
+	/**
+	 * Returns the smallest and largest compression levels accepted for a
+	 * method.
+	 */
+	static int MinLevel(Method method);
+	static int MaxLevel(Method method);
+
+	/**
+	 * Constructor.
+	 *
+	 * @param method The compression format to produce.
+	 *
+	 * @param level The compression level to pass to the library.
+	 *
+	 * @param num_threads The number of background threads compressing
+	 * blocks. With zero, blocks get compressed inline by the caller.
+	 *
+	 * @param block_size The number of uncompressed bytes per frame.
+	 */
+	BlockCompressor(Method method, int level, int num_threads, size_t block_size);
+
+	/**
+	 * Destructor. Stops the background threads. Any data not yet
+	 * written out through Close() is discarded.
+	 */
+	~BlockCompressor();
+
+	/**
+	 * Starts compressing into a new file.
+	 *
+	 * @param fd The file descriptor to write frames to. The compressor
+	 * does not take ownership.
+	 */
+	void Open(int fd);
+
+	/**
+	 * Adds data to the stream. Returns false if writing out a previous
+	 * block failed, see Error().
+	 */
+	bool Write(const char* data, size_t len);
+
+	/**
+	 * Compresses any partially filled block and waits until all pending
+	 * frames have been written to the file.
+	 */
+	bool Flush();
+
+	/**
+	 * Flushes all data and detaches from the current file descriptor.
+	 */
+	bool Close();
+
+	/**
+	 * Returns a description of the last error.
+	 */
+	const std::string& Error() const { return error; }
+
+private:
+	struct Job
+		{
+		std::string input;
+		std::string output;
+		std::string error;
+		bool done = false;
+		};
+
+	using JobPtr = std::shared_ptr<Job>;
+
+	void Worker();
+	void Compress(Job* job) const;
+	bool Submit();
+	bool WriteFrames(size_t max_outstanding);
+	bool WriteFrame(const Job& job);
+
+	Method method;
+	int level;
+	size_t block_size;
+	size_t max_pending;
+	int fd = -1;
+
+	std::string block; // Data not yet handed off for compression.
+	std::string error;
+
+	std::vector<std::thread> workers;
+	std::mutex mtx;
+	std::condition_variable has_work;
+	std::condition_variable has_result;
+	std::deque<JobPtr> todo; // Blocks waiting for a worker.
+	std::deque<JobPtr> pending; // All submitted blocks, in stream order.
+	bool terminating = false;
+	};
+
+	} // namespace zeek::logging::writer::detail
@@ -0,0 +1,172 @@
+// See the file "COPYING" in the main distribution directory for copyright.
+
+#include "zeek/logging/writers/snapshot/Snapshot.h"
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "zeek/threading/SerialTypes.h"
+#include "zeek/threading/Snapshot.h"
+#include "zeek/util.h"
+
+using namespace std;
+
+namespace zeek::logging::writer::detail
+	{
+
+// Amount of buffered data at which it gets written out.
+static constexpr size_t WRITE_THRESHOLD = 1024 * 1024;
+
+Snapshot::Snapshot(WriterFrontend* frontend) : WriterBackend(frontend) { }
+
+Snapshot::~Snapshot()
+	{
+	if ( fd >= 0 )
+		util::safe_close(fd);
+	}
+
+bool Snapshot::DoInit(const WriterInfo& info, int num_fields, const threading::Field* const* fields)
+	{
+	ext = threading::snapshot::DEFAULT_EXTENSION;
+
+	auto it = info.config.find("file_extension");
+
+	if ( it != info.config.end() )
+		ext = it->second;
+
+	fname = string(info.path) + "." + ext;
+	return OpenFile();
+	}
+
+bool Snapshot::OpenFile()
+	{
+	tmp_fname = fname + ".tmp";
+	fd = open(tmp_fname.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+
+	if ( fd < 0 )
+		{
+		Error(Fmt("cannot open %s: %s", tmp_fname.c_str(), Strerror(errno)));
+		return false;
+		}
+
+	buffer.assign(threading::snapshot::MAGIC, sizeof(threading::snapshot::MAGIC));
+
+	fmt.StartWrite();
+	fmt.Write(threading::snapshot::VERSION, "version");
+	fmt.Write(static_cast<uint32_t>(NumFields()), "num_fields");
+
+	for ( int i = 0; i < NumFields(); ++i )
+		Fields()[i]->Write(&fmt);
+
+	return AddBlock();
+	}
+
+bool Snapshot::AddBlock()
+	{
+	char* data;
+	uint32_t len = fmt.EndWrite(&data);
+	uint32_t nlen = htonl(len);
+
+	buffer.append(reinterpret_cast<const char*>(&nlen), sizeof(nlen));
+	buffer.append(data, len);
+	free(data);
+
+	if ( buffer.size() >= WRITE_THRESHOLD )
+		return WriteBuffer();
+
+	return true;
+	}
+
+bool Snapshot::WriteBuffer()
+	{
+	if ( buffer.empty() || fd < 0 )
+		return true;
+
+	if ( ! util::safe_write(fd, buffer.data(), buffer.size()) )
+		{
+		Error(Fmt("error writing to %s: %s", tmp_fname.c_str(), Strerror(errno)));
+		return false;
+		}
+
+	buffer.clear();
+	return true;
+	}
+
+bool Snapshot::CloseFile(const string& final_name)
+	{
+	bool rval = WriteBuffer();
+
+	util::safe_close(fd);
+	fd = -1;
+
+	if ( rename(tmp_fname.c_str(), final_name.c_str()) != 0 )
+		{
+		Error(Fmt("failed to rename %s to %s: %s", tmp_fname.c_str(), final_name.c_str(),
+		          Strerror(errno)));
+		return false;
+		}
+
+	return rval;
+	}
+
+bool Snapshot::DoWrite(int num_fields, const threading::Field* const* fields,
+                       threading::Value** vals)
+	{
+	if ( fd < 0 && ! OpenFile() )
+		return false;
+
+	fmt.StartWrite();
+
+	for ( int i = 0; i < num_fields; ++i )
+		vals[i]->Write(&fmt);
+
+	return AddBlock();
+	}
+
+bool Snapshot::DoFlush(double network_time)
+	{
+	// The file only gets published when it's complete, so there's
+	// nothing to sync here beyond handing data to the OS.
+	return WriteBuffer();
+	}
+
+bool Snapshot::DoFinish(double network_time)
+	{
+	if ( fd < 0 )
+		return true;
+
+	return CloseFile(fname);
+	}
+
+bool Snapshot::DoRotate(const char* rotated_path, double open, double close, bool terminating)
+	{
+	if ( fd < 0 )
+		{
+		FinishedRotation();
+		return true;
+		}
+
+	string nname = string(rotated_path) + "." + ext;
+
+	if ( ! CloseFile(nname) )
+		{
+		FinishedRotation();
+		return false;
+		}
+
+	if ( ! FinishedRotation(nname.c_str(), fname.c_str(), open, close, terminating) )
+		{
+		Error(Fmt("error rotating %s to %s", fname.c_str(), nname.c_str()));
+		return false;
+		}
+
+	// The next write opens a new file.
+	return true;
+	}
+
+	} // namespace zeek::logging::writer::detail
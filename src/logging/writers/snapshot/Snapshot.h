@@ -0,0 +1,59 @@
+// See the file "COPYING" in the main distribution directory for copyright.
+//
+// Log writer producing binary snapshot files for fast loading through the
+// input framework's snapshot reader.
+
+#pragma once
+
+#include <string>
+
+#include "zeek/SerializationFormat.h"
+#include "zeek/logging/WriterBackend.h"
+
+namespace zeek::logging::writer::detail
+	{
+
+/**
+ * Writes rows in the binary snapshot format described in
+ * zeek/threading/Snapshot.h.
+ *
+ * Data goes into a temporary file first, which gets renamed to its final
+ * name once the writer finishes or rotates. A snapshot file hence only
+ * becomes visible once it is complete, so that readers in REREAD mode
+ * never pick up a partially written one.
+ */
+class Snapshot : public WriterBackend
+	{
+public:
+	explicit Snapshot(WriterFrontend* frontend);
+	~Snapshot() override;
+
+	static WriterBackend* Instantiate(WriterFrontend* frontend) { return new Snapshot(frontend); }
+
+protected:
+	bool DoInit(const WriterInfo& info, int num_fields,
+	            const threading::Field* const* fields) override;
+	bool DoWrite(int num_fields, const threading::Field* const* fields,
+	             threading::Value** vals) override;
+	bool DoSetBuf(bool enabled) override { return true; }
+	bool DoRotate(const char* rotated_path, double open, double close, bool terminating) override;
+	bool DoFlush(double network_time) override;
+	bool DoFinish(double network_time) override;
+	bool DoHeartbeat(double network_time, double current_time) override { return true; }
+
+private:
+	bool OpenFile();
+	bool CloseFile(const std::string& final_name);
+	bool AddBlock();
+	bool WriteBuffer();
+
+	std::string fname; // Final name of the current file.
+	std::string tmp_fname; // Name while it's being written.
+	std::string ext;
+	int fd = -1;
+
+	std::string buffer; // Blocks not yet written to the file.
+	zeek::detail::BinarySerializationFormat fmt;
+	};
+
+	} // namespace zeek::logging::writer::detail
@@ -3,7 +3,9 @@
 #include "zeek/packet_analysis/protocol/ip/IPBasedAnalyzer.h"
 
 #include "zeek/Conn.h"
+#include "zeek/NetVar.h"
 #include "zeek/RunState.h"
+#include "zeek/Stats.h"
 #include "zeek/Val.h"
 #include "zeek/analyzer/Manager.h"
 #include "zeek/analyzer/protocol/pia/PIA.h"
@@ -35,7 +37,12 @@ bool IPBasedAnalyzer::AnalyzePacket(size_t len, const uint8_t* data, Packet* pkt
 	const std::shared_ptr<IP_Hdr>& ip_hdr = pkt->ip_hdr;
 	detail::ConnKey key(tuple);
 
-	Connection* conn = session_mgr->FindConnection(key);
+	Connection* conn;
+
+		{
+		zeek::detail::PacketStageTimer timer(zeek::detail::PacketStage::SessionLookup);
+		conn = session_mgr->FindConnection(key);
+		}
 
 	if ( ! conn )
 		{
@@ -96,7 +103,19 @@ bool IPBasedAnalyzer::AnalyzePacket(size_t len, const uint8_t* data, Packet* pkt
 	if ( conn->GetSessionAdapter()->Skipping() )
 		return true;
 
-	DeliverPacket(conn, run_state::processing_start_time, is_orig, len, pkt);
+	// All of a connection's data enters its analyzer tree here, which
+	// makes this the place to account it against the analysis budget.
+	uint64_t budget_start =
+		BifConst::AnalysisBudget::max_cpu_time > 0 ? zeek::detail::profile_ticks() : 0;
+
+		{
+		// The session adapter receives the packet directly rather than
+		// through its NextPacket().
+		analyzer::DeliveryCost cost(conn->GetSessionAdapter(), len);
+		DeliverPacket(conn, run_state::processing_start_time, is_orig, len, pkt);
+		}
+
+	conn->ChargeAnalysisBudget(len, budget_start);
 
 	run_state::current_timestamp = 0;
 	run_state::current_pkt = nullptr;
@@ -184,15 +203,20 @@ zeek::Connection* IPBasedAnalyzer::NewConn(const ConnTuple* id, const detail::Co
 
 void IPBasedAnalyzer::BuildSessionAnalyzerTree(Connection* conn)
 	{
+	// While shedding load, connections left out of the sample only get
+	// their transport-layer analysis.
+	bool analyze = ! run_state::detail::load_shedder ||
+	               run_state::detail::load_shedder->AnalyzeNewConnection();
+
 	SessionAdapter* root = MakeSessionAdapter(conn);
-	analyzer::pia::PIA* pia = MakePIA(conn);
+	analyzer::pia::PIA* pia = analyze ? MakePIA(conn) : nullptr;
 
-	bool scheduled = analyzer_mgr->ApplyScheduledAnalyzers(conn, false, root);
+	bool scheduled = analyze && analyzer_mgr->ApplyScheduledAnalyzers(conn, false, root);
 
 	// Hmm... Do we want *just* the expected analyzer, or all
 	// other potential analyzers as well?  For now we only take
 	// the scheduled ones.
-	if ( ! scheduled )
+	if ( analyze && ! scheduled )
 		{ // Let's see if it's a port we know.
 		if ( ! analyzers_by_port.empty() && ! zeek::detail::dpd_ignore_ports )
 			{
@@ -74,6 +74,13 @@ public:
 	 */
 	virtual FilePtr GetContentsFile(unsigned int direction) const;
 
+	/**
+	 * Stops reassembling the session's data, so that no further stream
+	 * data gets delivered to the analyzers.  The default implementation
+	 * does nothing, as only TCP does reassembly.
+	 */
+	virtual void StopReassembly() { }
+
 	/**
 	 * Associates a PIA with this analyzer. A PIA takes the
 	 * transport-layer input and determine which protocol analyzer(s) to
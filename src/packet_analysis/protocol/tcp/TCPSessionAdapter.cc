@@ -1339,6 +1339,15 @@ FilePtr TCPSessionAdapter::GetContentsFile(unsigned int direction) const
 	return nullptr;
 	}
 
+void TCPSessionAdapter::StopReassembly()
+	{
+	if ( orig->contents_processor )
+		orig->contents_processor->StopDeliveries();
+
+	if ( resp->contents_processor )
+		resp->contents_processor->StopDeliveries();
+	}
+
 void TCPSessionAdapter::ConnectionClosed(analyzer::tcp::TCP_Endpoint* endpoint,
                                          analyzer::tcp::TCP_Endpoint* peer, bool gen_event)
 	{
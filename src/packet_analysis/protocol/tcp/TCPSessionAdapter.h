@@ -72,6 +72,7 @@ public:
 
 	void SetContentsFile(unsigned int direction, FilePtr f) override;
 	FilePtr GetContentsFile(unsigned int direction) const override;
+	void StopReassembly() override;
 
 	// From Analyzer.h
 	void UpdateConnVal(RecordVal* conn_val) override;
@@ -127,7 +127,8 @@ class CPPCompile
 	{
 public:
 	CPPCompile(std::vector<FuncInfo>& _funcs, ProfileFuncs& pfs, const std::string& gen_name,
-	           bool add, bool _standalone, bool report_uncompilable);
+	           const std::string& stand_in_name, bool add, bool _standalone,
+	           bool report_uncompilable);
 	~CPPCompile();
 
 	// Constructing a CPPCompile object does all of the compilation.
@@ -786,6 +787,7 @@ private:
 	std::string GenIncrExpr(const Expr* e, GenType gt, bool is_incr, bool top_level);
 	std::string GenCondExpr(const Expr* e, GenType gt);
 	std::string GenCallExpr(const CallExpr* c, GenType gt);
+	std::string GenDirectBiFArgs(const ListExpr* args);
 	std::string GenInExpr(const Expr* e, GenType gt);
 	std::string GenFieldExpr(const FieldExpr* fe, GenType gt);
 	std::string GenHasFieldExpr(const HasFieldExpr* hfe, GenType gt);
@@ -1020,8 +1022,8 @@ private:
 	void GenStandaloneActivation();
 
 	// Generates code to register the initialization for standalone
-	// use, and prints to stdout a Zeek script that can load all of
-	// what we compiled.
+	// use, and writes a Zeek script that can load all of what we
+	// compiled to the stand-in file (by default, stdout).
 	void GenLoad();
 
 	// A list of BiFs to look up during initialization.  First
@@ -1123,6 +1125,9 @@ private:
 	// File to which we're generating code.
 	FILE* write_file;
 
+	// File to which we write the stand-in script for standalone code.
+	FILE* stand_in_file = stdout;
+
 	// Indentation level.
 	int block_level = 0;
 
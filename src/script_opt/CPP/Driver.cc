@@ -14,7 +14,8 @@ namespace zeek::detail
 using namespace std;
 
 CPPCompile::CPPCompile(vector<FuncInfo>& _funcs, ProfileFuncs& _pfs, const string& gen_name,
-                       bool add, bool _standalone, bool report_uncompilable)
+                       const string& stand_in_name, bool add, bool _standalone,
+                       bool report_uncompilable)
 	: funcs(_funcs), pfs(_pfs), standalone(_standalone)
 	{
 	auto target_name = gen_name.c_str();
@@ -53,12 +54,25 @@ CPPCompile::CPPCompile(vector<FuncInfo>& _funcs, ProfileFuncs& _pfs, const strin
 	else
 		addl_tag = 0;
 
+	if ( ! stand_in_name.empty() )
+		{
+		stand_in_file = fopen(stand_in_name.c_str(), "w");
+		if ( ! stand_in_file )
+			{
+			reporter->Error("can't open C++ stand-in file %s", stand_in_name.c_str());
+			exit(1);
+			}
+		}
+
 	Compile(report_uncompilable);
 	}
 
 CPPCompile::~CPPCompile()
 	{
 	fclose(write_file);
+
+	if ( stand_in_file != stdout )
+		fclose(stand_in_file);
 	}
 
 void CPPCompile::Compile(bool report_uncompilable)
@@ -343,12 +343,74 @@ string CPPCompile::GenCallExpr(const CallExpr* c, GenType gt)
 	auto args_list = string(", {") + GenExpr(args_l, GEN_VAL_PTR) + "}";
 	auto invoker = string("invoke__CPP(") + gen + args_list + ", f__CPP)";
 
+	if ( f->Tag() == EXPR_NAME && pfs.BiFGlobals().count(f->AsNameExpr()->Id()) > 0 )
+		{
+		// If the BiF has a direct version (see DirectBiFs.h), call
+		// that instead, unless at run-time a plugin hooks calls.
+		const auto& fv = f->AsNameExpr()->Id()->GetVal();
+		auto bif = fv ? fv->AsFunc() : nullptr;
+		auto direct_args = GenDirectBiFArgs(args_l);
+
+		if ( bif && bif->GetKind() == Func::BUILTIN_FUNC &&
+		     static_cast<const BuiltinFunc*>(bif)->TheDirectFunc() && ! direct_args.empty() )
+			invoker = string("(direct_BiF_ok__CPP(") + gen + ") ? direct_BiF__CPP(" + gen +
+			          direct_args + ", " + GenTypeName(t) + ") : " + invoker + ")";
+		}
+
 	if ( IsNativeType(t) && gt != GEN_VAL_PTR )
 		return invoker + NativeAccessor(t);
 
 	return GenericValPtrToGT(invoker, t, gt);
 	}
 
+string CPPCompile::GenDirectBiFArgs(const ListExpr* args)
+	{
+	// Generates ", {<ZVal args>}, {<arg types>}", or an empty string
+	// if some argument doesn't lend itself to a borrowed ZVal.
+	string zvals;
+	string types;
+
+	for ( auto a : args->Exprs() )
+		{
+		const auto& at = a->GetType();
+		string zv;
+
+		switch ( at->InternalType() )
+			{
+			case TYPE_INTERNAL_INT:
+				zv = string("ZVal(bro_int_t(") + GenExpr(a, GEN_NATIVE) + "))";
+				break;
+
+			case TYPE_INTERNAL_UNSIGNED:
+				zv = string("ZVal(bro_uint_t(") + GenExpr(a, GEN_NATIVE) + "))";
+				break;
+
+			case TYPE_INTERNAL_DOUBLE:
+				zv = string("ZVal(double(") + GenExpr(a, GEN_NATIVE) + "))";
+				break;
+
+			default:
+				// Files and functions aren't held as Val's in ZVals.
+				if ( at->Tag() == TYPE_FILE || at->Tag() == TYPE_FUNC )
+					return "";
+
+				zv = string("borrow_ZVal__CPP(") + GenExpr(a, GEN_VAL_PTR) + ")";
+				break;
+			}
+
+		if ( ! zvals.empty() )
+			{
+			zvals += ", ";
+			types += ", ";
+			}
+
+		zvals += zv;
+		types += GenTypeName(at);
+		}
+
+	return string(", {") + zvals + "}, {" + types + "}";
+	}
+
 string CPPCompile::GenInExpr(const Expr* e, GenType gt)
 	{
 	auto op1 = e->GetOp1();
@@ -0,0 +1,85 @@
+// See the file "COPYING" in the main distribution directory for copyright.
+
+#include "zeek/script_opt/CPP/GenPlugin.h"
+
+#include <cstdio>
+
+#include "zeek/Reporter.h"
+#include "zeek/util.h"
+
+namespace zeek::detail
+	{
+
+using namespace std;
+
+static FILE* open_plugin_file(const string& name)
+	{
+	auto f = fopen(name.c_str(), "w");
+	if ( ! f )
+		reporter->FatalError("can't open C++ plugin file %s", name.c_str());
+
+	return f;
+	}
+
+void gen_CPP_plugin_skeleton(const string& dir, const string& plugin_name)
+	{
+	auto sep = plugin_name.find("::");
+	if ( sep == string::npos || sep == 0 || sep + 2 == plugin_name.size() ||
+	     plugin_name.find("::", sep + 2) != string::npos )
+		reporter->FatalError("C++ plugin name \"%s\" is not of the form Namespace::Name",
+		                     plugin_name.c_str());
+
+	auto ns = plugin_name.substr(0, sep);
+	auto name = plugin_name.substr(sep + 2);
+	auto cpp_ns = ns + "_" + name;
+
+	auto src_dir = dir + "src";
+	auto scripts_dir = dir + "scripts";
+
+	if ( ! util::detail::ensure_intermediate_dirs(src_dir.c_str()) ||
+	     ! util::detail::ensure_intermediate_dirs(scripts_dir.c_str()) )
+		reporter->FatalError("can't create C++ plugin directory %s", dir.c_str());
+
+	auto f = open_plugin_file(dir + "CMakeLists.txt");
+	fprintf(f, "# Generated by \"zeek -O gen-C++-plugin\", do not edit.\n\n");
+	fprintf(f, "cmake_minimum_required(VERSION 3.15 FATAL_ERROR)\n\n");
+	fprintf(f, "project(ZeekPlugin%s%s)\n\n", ns.c_str(), name.c_str());
+	fprintf(f, "include(ZeekPlugin)\n\n");
+	fprintf(f, "zeek_plugin_begin(%s %s)\n", ns.c_str(), name.c_str());
+	fprintf(f, "zeek_plugin_cc(src/Plugin.cc)\n");
+	fprintf(f, "zeek_plugin_cc(src/CPP-gen.cc)\n");
+	fprintf(f, "zeek_plugin_end()\n");
+	fclose(f);
+
+	f = open_plugin_file(src_dir + "/Plugin.h");
+	fprintf(f, "// Generated by \"zeek -O gen-C++-plugin\", do not edit.\n\n");
+	fprintf(f, "#pragma once\n\n");
+	fprintf(f, "#include \"zeek/plugin/Plugin.h\"\n\n");
+	fprintf(f, "namespace plugin::%s\n\t{\n\n", cpp_ns.c_str());
+	fprintf(f, "class Plugin : public zeek::plugin::Plugin\n\t{\n");
+	fprintf(f, "protected:\n");
+	fprintf(f, "\tzeek::plugin::Configuration Configure() override;\n");
+	fprintf(f, "\t};\n\n");
+	fprintf(f, "extern Plugin plugin;\n\n");
+	fprintf(f, "\t}\n");
+	fclose(f);
+
+	f = open_plugin_file(src_dir + "/Plugin.cc");
+	fprintf(f, "// Generated by \"zeek -O gen-C++-plugin\", do not edit.\n\n");
+	fprintf(f, "#include \"Plugin.h\"\n\n");
+	fprintf(f, "namespace plugin::%s\n\t{\n\n", cpp_ns.c_str());
+	fprintf(f, "Plugin plugin;\n\n");
+	fprintf(f, "zeek::plugin::Configuration Plugin::Configure()\n\t{\n");
+	fprintf(f, "\tzeek::plugin::Configuration config;\n");
+	fprintf(f, "\tconfig.name = \"%s\";\n", plugin_name.c_str());
+	fprintf(f, "\tconfig.description = \"Compiled-to-C++ scripts\";\n");
+	fprintf(f, "\tconfig.version.major = 0;\n");
+	fprintf(f, "\tconfig.version.minor = 1;\n");
+	fprintf(f, "\tconfig.version.patch = 0;\n");
+	fprintf(f, "\treturn config;\n");
+	fprintf(f, "\t}\n\n");
+	fprintf(f, "\t}\n");
+	fclose(f);
+	}
+
+	} // namespace zeek::detail
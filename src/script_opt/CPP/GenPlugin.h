@@ -0,0 +1,25 @@
+// See the file "COPYING" in the main distribution directory for copyright.
+
+// Support for packaging compiled-to-C++ scripts as a dynamically loadable
+// Zeek plugin, rather than as code that has to be built into the "zeek"
+// binary itself.
+
+#pragma once
+
+#include <string>
+
+namespace zeek::detail
+	{
+
+// Writes to the given directory the files (other than the generated code
+// itself) needed to build a plugin with the given "Namespace::Name" that
+// holds the compiled scripts: a CMakeLists.txt and the plugin's
+// src/Plugin.{h,cc}.  Also creates the src/ and scripts/ subdirectories
+// for the generated code and the stand-in script that loads it.
+//
+// The directory is expected to have been set up using "init-plugin", which
+// provides the "configure" script and build machinery.  Exits with an
+// error if the plugin name is malformed or the files can't be written.
+extern void gen_CPP_plugin_skeleton(const std::string& dir, const std::string& plugin_name);
+
+	} // namespace zeek::detail
@@ -290,15 +290,20 @@ void CPPCompile::GenStandaloneActivation()
 
 void CPPCompile::GenLoad()
 	{
-	// First, generate a hash unique to this compilation.
-	auto t = util::current_time();
-	auto th = hash<double>{}(t);
+	// First, generate a hash unique to this compilation.  A plugin's
+	// stand-in script instead has to match the code it's shipped with,
+	// so for those we stick with the hash of the compiled bodies alone.
+	if ( ! analysis_options.gen_CPP_plugin )
+		{
+		auto t = util::current_time();
+		auto th = hash<double>{}(t);
 
-	total_hash = merge_p_hashes(total_hash, th);
+		total_hash = merge_p_hashes(total_hash, th);
+		}
 
 	Emit("register_scripts__CPP(%s, standalone_init__CPP);", Fmt(total_hash));
 
-	printf("global init_CPP_%llu = load_CPP(%llu);\n", total_hash, total_hash);
+	fprintf(stand_in_file, "global init_CPP_%llu = load_CPP(%llu);\n", total_hash, total_hash);
 	}
 
 	} // zeek::detail
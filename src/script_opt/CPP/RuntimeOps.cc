@@ -267,6 +267,21 @@ VectorValPtr vector_constructor__CPP(vector<ValPtr> vals, VectorTypePtr t)
 	return vv;
 	}
 
+ValPtr direct_BiF__CPP(const Func* f, std::initializer_list<ZVal> args,
+                       std::initializer_list<TypePtr> arg_types, const TypePtr& ret_type)
+	{
+	auto df = static_cast<const BuiltinFunc*>(f)->TheDirectFunc();
+	auto zv = df(args.begin(), arg_types.begin(), static_cast<int>(args.size()));
+
+	if ( ret_type->Tag() == TYPE_VOID )
+		return nullptr;
+
+	auto rv = zv.ToVal(ret_type);
+	ZVal::DeleteIfManaged(zv, ret_type);
+
+	return rv;
+	}
+
 ValPtr schedule__CPP(double dt, EventHandlerPtr event, vector<ValPtr> args)
 	{
 	if ( ! run_state::terminating )
@@ -5,7 +5,9 @@
 #pragma once
 
 #include "zeek/Val.h"
+#include "zeek/ZVal.h"
 #include "zeek/script_opt/CPP/Func.h"
+#include "zeek/script_opt/DirectBiFs.h"
 
 namespace zeek
 	{
@@ -41,6 +43,22 @@ inline ValPtr invoke__CPP(Func* f, std::vector<ValPtr> args, Frame* frame)
 	return f->Invoke(&args, frame);
 	}
 
+// Support for calling BiFs directly with ZVal arguments, bypassing Invoke().
+// The first returns true if the given BiF can be called that way, which
+// depends on whether a plugin hooks function calls.  The second makes the
+// call, with arguments that borrow their values, for which non-native ones
+// can be constructed using the third.
+inline bool direct_BiF_ok__CPP(const Func* f)
+	{
+	return direct_BiF_for_call(f) != nullptr;
+	}
+extern ValPtr direct_BiF__CPP(const Func* f, std::initializer_list<ZVal> args,
+                              std::initializer_list<TypePtr> arg_types, const TypePtr& ret_type);
+inline ZVal borrow_ZVal__CPP(const ValPtr& v)
+	{
+	return ZVal(v.get());
+	}
+
 // Assigns the given value to the given global.  A separate function because
 // we also need to return the value, for use in assignment cascades.
 inline ValPtr set_global__CPP(IDPtr g, ValPtr v)
@@ -416,11 +416,11 @@ VectorValPtr vector_coerce_to__CPP(const VectorValPtr& v, const TypePtr& targ)
 				break;
 
 			case TYPE_DOUBLE:
-				r_i = make_intrusive<DoubleVal>(v_i->CoerceToDouble());
+				r_i = val_mgr->Double(v_i->CoerceToDouble());
 				break;
 
 			case TYPE_INTERVAL:
-				r_i = make_intrusive<IntervalVal>(v_i->CoerceToDouble());
+				r_i = val_mgr->Interval(v_i->CoerceToDouble());
 				break;
 
 			case TYPE_TIME:
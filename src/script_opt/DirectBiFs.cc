@@ -0,0 +1,42 @@
+// See the file "COPYING" in the main distribution directory for copyright.
+
+#include "zeek/script_opt/DirectBiFs.h"
+
+#include <string>
+#include <unordered_map>
+
+#include "zeek/plugin/Manager.h"
+
+namespace zeek::detail
+	{
+
+direct_built_in_func find_direct_BiF(const char* name)
+	{
+	// Function-local so it's available when BuiltinFunc's get
+	// constructed, regardless of static initialization order.
+	static const std::unordered_map<std::string, direct_built_in_func> direct_BiFs = {
+		{"cat", direct_BiF_cat},
+		{"is_v4_addr", direct_BiF_is_v4_addr},
+		{"is_v6_addr", direct_BiF_is_v6_addr},
+		{"split_string", direct_BiF_split_string},
+		{"strip", direct_BiF_strip},
+		{"to_lower", direct_BiF_to_lower},
+		{"to_upper", direct_BiF_to_upper},
+	};
+
+	auto db = direct_BiFs.find(name);
+	return db == direct_BiFs.end() ? nullptr : db->second;
+	}
+
+direct_built_in_func direct_BiF_for_call(const Func* f)
+	{
+	if ( f->GetKind() != Func::BUILTIN_FUNC )
+		return nullptr;
+
+	if ( plugin_mgr->HavePluginForHook(plugin::HOOK_CALL_FUNCTION) )
+		return nullptr;
+
+	return static_cast<const BuiltinFunc*>(f)->TheDirectFunc();
+	}
+
+	} // namespace zeek::detail
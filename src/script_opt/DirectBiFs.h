@@ -0,0 +1,40 @@
+// See the file "COPYING" in the main distribution directory for copyright.
+
+// Versions of frequently called BiFs that take their arguments as ZVals
+// rather than as a vector of Val's, for use by compiled scripts (ZAM and
+// C++).  Such calls bypass BuiltinFunc::Invoke(), and with it boxing each
+// argument into a Val, the call stack, plugin hooks and tracing.  For the
+// first of these reasons, direct versions are only provided for BiFs that
+// never report run-time errors, as those messages refer to the call stack.
+//
+// The direct versions live next to the regular ones in the .bif files so
+// that the two can share their helper functions.  Adding one means defining
+// it there, declaring it below, and listing it in DirectBiFs.cc.
+
+#pragma once
+
+#include "zeek/Func.h"
+#include "zeek/ZVal.h"
+
+namespace zeek::detail
+	{
+
+// Returns the direct version of the BiF with the given (fully qualified)
+// name, or nil if it doesn't have one.
+extern direct_built_in_func find_direct_BiF(const char* name);
+
+// Returns the direct version to use for a call to the given function, or
+// nil if either it doesn't have one or direct calls can't be used because
+// a plugin hooks function calls.
+extern direct_built_in_func direct_BiF_for_call(const Func* f);
+
+// The direct versions of BiFs, named after the BiFs themselves.
+extern ZVal direct_BiF_cat(const ZVal* args, const TypePtr* arg_types, int nargs);
+extern ZVal direct_BiF_is_v4_addr(const ZVal* args, const TypePtr* arg_types, int nargs);
+extern ZVal direct_BiF_is_v6_addr(const ZVal* args, const TypePtr* arg_types, int nargs);
+extern ZVal direct_BiF_split_string(const ZVal* args, const TypePtr* arg_types, int nargs);
+extern ZVal direct_BiF_strip(const ZVal* args, const TypePtr* arg_types, int nargs);
+extern ZVal direct_BiF_to_lower(const ZVal* args, const TypePtr* arg_types, int nargs);
+extern ZVal direct_BiF_to_upper(const ZVal* args, const TypePtr* arg_types, int nargs);
+
+	} // namespace zeek::detail
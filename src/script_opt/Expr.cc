@@ -458,11 +458,11 @@ ValPtr Expr::MakeZero(TypeTag t) const
 			return val_mgr->Count(0);
 
 		case TYPE_DOUBLE:
-			return make_intrusive<DoubleVal>(0.0);
+			return val_mgr->Double(0.0);
 		case TYPE_TIME:
 			return make_intrusive<TimeVal>(0.0);
 		case TYPE_INTERVAL:
-			return make_intrusive<IntervalVal>(0.0, 1.0);
+			return val_mgr->Interval(0.0);
 
 		default:
 			reporter->InternalError("bad call to MakeZero");
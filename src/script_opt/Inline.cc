@@ -5,6 +5,7 @@
 #include "zeek/Desc.h"
 #include "zeek/script_opt/ProfileFunc.h"
 #include "zeek/script_opt/ScriptOpt.h"
+#include "zeek/script_opt/ZAM/Support.h"
 
 namespace zeek::detail
 	{
@@ -127,6 +128,9 @@ void Inliner::Analyze()
 	for ( auto& f : funcs )
 		if ( should_analyze(f.FuncPtr(), f.Body()) )
 			InlineFunction(&f);
+
+	if ( analysis_options.fuse_events )
+		FuseEventBodies();
 	}
 
 void Inliner::InlineFunction(FuncInfo* f)
@@ -147,6 +151,131 @@ void Inliner::InlineFunction(FuncInfo* f)
 		f->Func()->SetFrameSize(new_frame_size);
 	}
 
+void Inliner::FuseEventBodies()
+	{
+	std::unordered_map<const Func*, std::vector<FuncInfo*>> event_bodies;
+
+	for ( auto& f : funcs )
+		if ( f.Func()->Flavor() == FUNC_FLAVOR_EVENT )
+			event_bodies[f.Func()].push_back(&f);
+
+	for ( auto& eb : event_bodies )
+		if ( eb.second.size() > 1 )
+			FuseBodies(eb.second);
+	}
+
+void Inliner::FuseBodies(const std::vector<FuncInfo*>& infos)
+	{
+	auto func = infos[0]->Func();
+	const auto& bodies = func->GetBodies();
+
+	if ( bodies.size() != infos.size() )
+		return;
+
+	// Same restrictions as for inlining functions.  In addition, all of
+	// the bodies need to be compilable, since otherwise the fused body
+	// won't be, and we'd lose more than we'd gain.
+	std::unordered_map<const Stmt*, FuncInfo*> body_to_info;
+
+	for ( auto f : infos )
+		{
+		auto pf = f->Profile();
+
+		if ( ! should_analyze(f->FuncPtr(), f->Body()) || f->Body()->Tag() == STMT_CPP ||
+		     pf->NumLambdas() > 0 || pf->NumWhenStmts() > 0 || ! is_ZAM_compilable(pf) )
+			return;
+
+		body_to_info[f->Body().get()] = f;
+		}
+
+	// All of the bodies have their parameters first in their scopes,
+	// at the same offsets, but with their own identifiers.  We use
+	// those of the first body for the fused body, and inline each body
+	// with its own parameters.  (That includes the first one, so that
+	// a "return" in it only ends that part.)
+	int nparam = func->GetType()->Params()->NumFields();
+	int body_frame_size = func->FrameSize();
+	auto void_type = base_type(TYPE_VOID);
+
+	auto host = body_to_info[bodies[0].stmts.get()];
+	const auto& host_vars = host->Scope()->OrderedVars();
+
+	auto fused = make_intrusive<StmtList>();
+	fused->SetLocationInfo(bodies[0].stmts->GetLocationInfo());
+
+	// The first body's parameters are the fused body's, so assigning
+	// to one of them would change what the later bodies see.  Instead,
+	// the bodies get their arguments from copies made up front, which
+	// follow the parameters in the frame.
+	int frame_offset = nparam;
+	std::vector<IDPtr> arg_copies;
+	arg_copies.reserve(nparam);
+
+	for ( int i = 0; i < nparam; ++i )
+		{
+		auto name = std::string(host_vars[i]->Name()) + ".arg";
+		auto copy = make_intrusive<ID>(name.c_str(), SCOPE_FUNCTION, false);
+		copy->SetType(host_vars[i]->GetType());
+		copy->SetOffset(frame_offset++);
+
+		auto assign = make_intrusive<AssignExpr>(make_intrusive<NameExpr>(copy),
+		                                         make_intrusive<NameExpr>(host_vars[i]), false,
+		                                         nullptr, nullptr, false);
+		fused->Stmts().push_back(make_intrusive<ExprStmt>(assign).release());
+
+		arg_copies.emplace_back(std::move(copy));
+		}
+
+	// If executed without first being reduced, each inlined body
+	// occupies its own region of the frame, after the copies.
+
+	for ( const auto& b : bodies )
+		{
+		auto f = body_to_info[b.stmts.get()];
+
+		if ( ! f )
+			return;
+
+		const auto& vars = f->Scope()->OrderedVars();
+
+		auto args = make_intrusive<ListExpr>();
+		std::vector<IDPtr> params;
+		params.reserve(nparam);
+
+		for ( int i = 0; i < nparam; ++i )
+			{
+			args->Append(make_intrusive<NameExpr>(arg_copies[i]));
+			params.emplace_back(vars[i]);
+			}
+
+		auto ie = make_intrusive<InlineExpr>(args, std::move(params), b.stmts->Duplicate(),
+		                                     frame_offset, void_type);
+		ie->SetLocationInfo(b.stmts->GetLocationInfo());
+
+		fused->Stmts().push_back(make_intrusive<ExprStmt>(ie).release());
+
+		frame_offset += body_frame_size;
+		}
+
+	if ( frame_offset > func->FrameSize() )
+		func->SetFrameSize(frame_offset);
+
+	// The first body's FuncInfo now stands for the fused body, and the
+	// others drop out of further optimization.
+	for ( auto f : infos )
+		{
+		if ( f == host )
+			continue;
+
+		func->ReplaceBody(f->Body(), nullptr);
+		f->SetSkip(true);
+		}
+
+	func->ReplaceBody(host->Body(), fused);
+	host->SetBody(fused);
+	host->SetProfile(std::make_shared<ProfileFunc>(func, fused, true));
+	}
+
 ExprPtr Inliner::CheckForInlining(CallExprPtr c)
 	{
 	auto f = c->Func();
@@ -42,6 +42,16 @@ protected:
 	// Recursively inlines any calls associated with the given function.
 	void InlineFunction(FuncInfo* f);
 
+	// Combines the bodies of each event handler that has more than one
+	// into a single body, which inlines each of them in priority order.
+	// This lets the optimizer share work across the bodies, such as
+	// loading the same record fields.
+	void FuseEventBodies();
+
+	// Fuses the given bodies of a single event handler, if they're all
+	// suitable for it.
+	void FuseBodies(const std::vector<FuncInfo*>& bodies);
+
 	// Information about all of the functions (and events/hooks) in
 	// the full set of scripts.
 	std::vector<FuncInfo>& funcs;
@@ -10,11 +10,13 @@
 #include "zeek/module_util.h"
 #include "zeek/script_opt/CPP/Compile.h"
 #include "zeek/script_opt/CPP/Func.h"
+#include "zeek/script_opt/CPP/GenPlugin.h"
 #include "zeek/script_opt/GenIDDefs.h"
 #include "zeek/script_opt/Inline.h"
 #include "zeek/script_opt/ProfileFunc.h"
 #include "zeek/script_opt/Reduce.h"
 #include "zeek/script_opt/UseDefs.h"
+#include "zeek/script_opt/ZAM/Cache.h"
 #include "zeek/script_opt/ZAM/Compile.h"
 
 namespace zeek::detail
@@ -34,6 +36,8 @@ static ZAMCompiler* ZAM = nullptr;
 
 static bool generating_CPP = false;
 static std::string CPP_dir; // where to generate C++ code
+static std::string CPP_plugin_name = "Zeek::CompiledScripts";
+static std::string ZAM_cache_dir; // where to keep compiled ZAM bodies
 
 static ScriptFuncPtr global_stmts;
 
@@ -256,10 +260,19 @@ static void init_options()
 	if ( cppd )
 		CPP_dir = std::string(cppd) + "/";
 
+	auto cppp = getenv("ZEEK_CPP_PLUGIN");
+	if ( cppp )
+		CPP_plugin_name = cppp;
+
+	auto zcd = getenv("ZEEK_ZAM_CACHE_DIR");
+	if ( zcd )
+		ZAM_cache_dir = zcd;
+
 	// ZAM-related options.
 	check_env_opt("ZEEK_DUMP_XFORM", analysis_options.dump_xform);
 	check_env_opt("ZEEK_DUMP_UDS", analysis_options.dump_uds);
 	check_env_opt("ZEEK_INLINE", analysis_options.inliner);
+	check_env_opt("ZEEK_FUSE_EVENTS", analysis_options.fuse_events);
 	check_env_opt("ZEEK_OPT", analysis_options.optimize_AST);
 	check_env_opt("ZEEK_XFORM", analysis_options.activate);
 	check_env_opt("ZEEK_ZAM", analysis_options.gen_ZAM);
@@ -268,15 +281,30 @@ static void init_options()
 	check_env_opt("ZEEK_NO_ZAM_OPT", analysis_options.no_ZAM_opt);
 	check_env_opt("ZEEK_DUMP_ZAM", analysis_options.dump_ZAM);
 	check_env_opt("ZEEK_PROFILE", analysis_options.profile_ZAM);
+	check_env_opt("ZEEK_REPORT_ZAM_CACHE", analysis_options.report_ZAM_cache);
 
 	// Compile-to-C++-related options.
 	check_env_opt("ZEEK_ADD_CPP", analysis_options.add_CPP);
 	check_env_opt("ZEEK_GEN_CPP", analysis_options.gen_CPP);
 	check_env_opt("ZEEK_GEN_STANDALONE_CPP", analysis_options.gen_standalone_CPP);
+	check_env_opt("ZEEK_GEN_CPP_PLUGIN", analysis_options.gen_CPP_plugin);
 	check_env_opt("ZEEK_COMPILE_ALL", analysis_options.compile_all);
 	check_env_opt("ZEEK_REPORT_CPP", analysis_options.report_CPP);
 	check_env_opt("ZEEK_USE_CPP", analysis_options.use_CPP);
 
+	if ( analysis_options.gen_CPP_plugin )
+		{
+		if ( analysis_options.add_CPP )
+			reporter->FatalError("generating a C++ plugin incompatible with adding C++");
+
+		// Otherwise the plugin's files would land in the current
+		// directory.
+		if ( CPP_dir.empty() )
+			reporter->FatalError("generating a C++ plugin requires ZEEK_CPP_DIR");
+
+		analysis_options.gen_standalone_CPP = true;
+		}
+
 	if ( analysis_options.gen_standalone_CPP || analysis_options.add_CPP )
 		analysis_options.gen_CPP = true;
 
@@ -305,6 +333,9 @@ static void init_options()
 			add_file_analysis_pattern(analysis_options, zo);
 		}
 
+	if ( analysis_options.fuse_events )
+		analysis_options.inliner = true;
+
 	if ( analysis_options.gen_ZAM )
 		{
 		analysis_options.gen_ZAM_code = true;
@@ -415,13 +446,23 @@ static void use_CPP()
 
 static void generate_CPP(std::unique_ptr<ProfileFuncs>& pfs)
 	{
-	const auto gen_name = CPP_dir + "CPP-gen.cc";
+	auto gen_name = CPP_dir + "CPP-gen.cc";
+	std::string stand_in_name; // empty means stdout
+
+	if ( analysis_options.gen_CPP_plugin )
+		{
+		// The plugin's stand-in script gets loaded automatically
+		// when Zeek activates the plugin.
+		gen_CPP_plugin_skeleton(CPP_dir, CPP_plugin_name);
+		gen_name = CPP_dir + "src/CPP-gen.cc";
+		stand_in_name = CPP_dir + "scripts/__load__.zeek";
+		}
 
 	const bool add = analysis_options.add_CPP;
 	const bool standalone = analysis_options.gen_standalone_CPP;
 	const bool report = analysis_options.report_uncompilable;
 
-	CPPCompile cpp(funcs, *pfs, gen_name, add, standalone, report);
+	CPPCompile cpp(funcs, *pfs, gen_name, stand_in_name, add, standalone, report);
 	}
 
 static void analyze_scripts_for_ZAM(std::unique_ptr<ProfileFuncs>& pfs)
@@ -483,12 +524,27 @@ static void analyze_scripts_for_ZAM(std::unique_ptr<ProfileFuncs>& pfs)
 			}
 		}
 
+	// The debugging dumps are produced as a side effect of compiling,
+	// so don't let the cache skip that.
+	std::unique_ptr<ZAMCache> cache;
+	if ( ! ZAM_cache_dir.empty() && analysis_options.gen_ZAM_code &&
+	     ! analysis_options.dump_ZAM && ! analysis_options.dump_xform &&
+	     ! analysis_options.dump_uds )
+		{
+		cache = std::make_unique<ZAMCache>(ZAM_cache_dir, funcs);
+		cache->Load();
+		}
+
 	bool did_one = false;
 
 	for ( auto& f : funcs )
 		{
 		auto func = f.Func();
 
+		if ( f.ShouldSkip() )
+			// Its body has been fused into another one.
+			continue;
+
 		if ( ! analysis_options.only_funcs.empty() || ! analysis_options.only_files.empty() )
 			{
 			if ( ! should_analyze(f.FuncPtr(), f.Body()) )
@@ -500,14 +556,43 @@ static void analyze_scripts_for_ZAM(std::unique_ptr<ProfileFuncs>& pfs)
 			// No need to compile as it won't be called directly.
 			continue;
 
+		did_one = true;
+
+		std::string cache_name;
+
+		if ( cache && f.Body()->Tag() != STMT_CPP )
+			{
+			cache_name = cache->EntryName(f);
+
+			auto zb = cache->Lookup(cache_name, func);
+			if ( zb )
+				{
+				func->ReplaceBody(f.Body(), zb);
+				f.SetBody(zb);
+				continue;
+				}
+			}
+
 		auto new_body = f.Body();
 		optimize_func(func, f.ProfilePtr(), f.Scope(), new_body);
+
+		if ( ! cache_name.empty() && new_body->Tag() == STMT_ZAM )
+			cache->Add(cache_name, func, static_cast<const ZBody*>(new_body.get()));
+
 		f.SetBody(new_body);
-		did_one = true;
 		}
 
 	if ( ! did_one )
 		reporter->FatalError("no matching functions/files for -O ZAM");
+
+	if ( cache )
+		{
+		cache->Save();
+		cache->RemoveStale();
+
+		if ( analysis_options.report_ZAM_cache )
+			printf("ZAM cache: %d bodies loaded, %d added\n", cache->NumHits(), cache->NumAdded());
+		}
 	}
 
 void analyze_scripts()
@@ -58,6 +58,12 @@ struct AnalyOpt
 	// recursive, and exit.  Only germane if running the inliner.
 	bool report_recursive = false;
 
+	// If true, combine the bodies of each event handler into a single
+	// one, so they can be optimized together.  Only germane if running
+	// the inliner.  Not done by default since a run-time error in one
+	// of the bodies then keeps the remaining ones from executing.
+	bool fuse_events = false;
+
 	// If true, generate ZAM code for applicable function bodies,
 	// activating all optimizations.
 	bool gen_ZAM = false;
@@ -83,6 +89,10 @@ struct AnalyOpt
 	// If true, dump out generated ZAM code.
 	bool dump_ZAM = false;
 
+	// If true, report how many bodies were loaded from and added to
+	// the ZAM cache.
+	bool report_ZAM_cache = false;
+
 	// If non-zero, looks for variables that are used-but-possibly-not-set,
 	// or set-but-not-used.  We store this as an int rather than a bool
 	// because we might at some point extend the analysis to deeper forms
@@ -102,6 +112,10 @@ struct AnalyOpt
 	// of the corresponding script, and not activated by default).
 	bool gen_standalone_CPP = false;
 
+	// If true, package the standalone C++ as a dynamically loadable
+	// plugin, so that using it doesn't require rebuilding Zeek.
+	bool gen_CPP_plugin = false;
+
 	// Generate C++ that's added to existing generated code.
 	bool add_CPP = false;
 
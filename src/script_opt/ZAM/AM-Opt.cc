@@ -120,6 +120,17 @@ void ZAMCompiler::OptimizeInsts()
 				}
 			}
 
+		if ( FuseInsts() )
+			{
+			something_changed = true;
+
+			if ( dump_intermediaries )
+				{
+				printf("Did some fusing:\n");
+				DumpInsts1(nullptr);
+				}
+			}
+
 		ComputeFrameLifetimes();
 
 		if ( PruneUnused() )
@@ -308,6 +319,22 @@ bool ZAMCompiler::PruneUnused()
 			continue;
 			}
 
+		if ( inst->op == OP_FIELD_IF_HAS_VVVV )
+			{
+			// The fused load is dead, but its test still guards
+			// the branch, so revert to the plain test.
+			inst->op = OP_HAS_FIELD_COND_VVV;
+			inst->op_type = OP_VVV_I2_I3;
+			inst->v1 = inst->v2;
+			inst->v2 = inst->v3;
+			inst->v3 = inst->v4;
+			inst->target_slot = 3;
+			inst->t = nullptr;
+			inst->is_managed = false;
+			did_prune = true;
+			continue;
+			}
+
 		// Assignment to a local that isn't otherwise used.
 		if ( ! inst->HasSideEffects() )
 			{
@@ -935,6 +962,69 @@ bool ZAMCompiler::VarIsUsed(int slot) const
 	return false;
 	}
 
+// True if the given instruction loads a record field into a variable.
+static bool is_field_load(const ZInstI* inst)
+	{
+	switch ( inst->op )
+		{
+		case OP_FIELD_RVi_A:
+		case OP_FIELD_RVi_D:
+		case OP_FIELD_RVi_F:
+		case OP_FIELD_RVi_I:
+		case OP_FIELD_RVi_L:
+		case OP_FIELD_RVi_N:
+		case OP_FIELD_RVi_O:
+		case OP_FIELD_RVi_P:
+		case OP_FIELD_RVi_R:
+		case OP_FIELD_RVi_S:
+		case OP_FIELD_RVi_T:
+		case OP_FIELD_RVi_U:
+		case OP_FIELD_RVi_V:
+		case OP_FIELD_RVi_a:
+		case OP_FIELD_RVi_f:
+		case OP_FIELD_RVi_t:
+			return true;
+
+		default:
+			return false;
+		}
+	}
+
+bool ZAMCompiler::FuseInsts()
+	{
+	bool did_fuse = false;
+
+	for ( auto& i0 : insts1 )
+		{
+		if ( ! i0->live || i0->op != OP_HAS_FIELD_COND_VVV )
+			continue;
+
+		// Look for "if ( r?$f ) ... r$f ...", i.e., a test for a field
+		// followed directly by loading the same field.  The load must
+		// not be a branch target, since then it could execute without
+		// the test.
+		auto i1 = NextLiveInst(i0);
+
+		if ( ! i1 || i1->num_labels > 0 || ! is_field_load(i1) || i1->v2 != i0->v1 ||
+		     i1->v3 != i0->v2 )
+			continue;
+
+		i0->op = OP_FIELD_IF_HAS_VVVV;
+		i0->op_type = OP_VVVV_I3_I4;
+		i0->v4 = i0->v3;
+		i0->v3 = i0->v2;
+		i0->v2 = i0->v1;
+		i0->v1 = i1->v1;
+		i0->target_slot = 4;
+		i0->SetType(i1->t);
+
+		KillInst(i1);
+		did_fuse = true;
+		}
+
+	return did_fuse;
+	}
+
 ZInstI* ZAMCompiler::FirstLiveInst(ZInstI* i, bool follow_gotos)
 	{
 	if ( i == pending_inst )
@@ -5,6 +5,7 @@
 
 #include "zeek/Func.h"
 #include "zeek/Reporter.h"
+#include "zeek/script_opt/DirectBiFs.h"
 #include "zeek/script_opt/ZAM/Compile.h"
 
 namespace zeek::detail
@@ -63,7 +64,46 @@ bool ZAMCompiler::IsZAM_BuiltIn(const Expr* e)
 		if ( util::streq(func->Name(), b.first) )
 			return (this->*(b.second))(n, args);
 
-	return false;
+	return DirectBiFCall(n, func, args);
+	}
+
+bool ZAMCompiler::DirectBiFCall(const NameExpr* n, Func* func, const ExprPList& args)
+	{
+	if ( ! direct_BiF_for_call(func) )
+		return false;
+
+	int nargs = args.length();
+	auto aux = new ZInstAux(nargs);
+
+	for ( int i = 0; i < nargs; ++i )
+		{
+		auto ai = args[i];
+
+		if ( ai->Tag() == EXPR_NAME )
+			aux->Add(i, FrameSlot(ai->AsNameExpr()), ai->GetType());
+		else
+			{
+			aux->Add(i, ai->AsConstExpr()->ValuePtr());
+			// BiFs with variable arguments need to know the
+			// types of constants, too.
+			aux->types[i] = ai->GetType();
+			}
+		}
+
+	ZInstI z;
+
+	if ( n )
+		z = ZInstI(OP_DIRECT_BIF_CALL_V, Frame1Slot(n, OP1_WRITE));
+	else
+		z = ZInstI(OP_DIRECT_BIF_CALL_X);
+
+	z.func = func;
+	z.aux = aux;
+	z.SetType(func->GetType()->Yield());
+
+	AddInst(z);
+
+	return true;
 	}
 
 bool ZAMCompiler::BuiltIn_Analyzer__name(const NameExpr* n, const ExprPList& args)
@@ -11,6 +11,10 @@
 // then compiles the call and returns true.  Otherwise, returns false.
 bool IsZAM_BuiltIn(const Expr* e);
 
+// If the given BiF has a version taking ZVal arguments, compiles a direct
+// call to it and returns true.  Otherwise, returns false.
+bool DirectBiFCall(const NameExpr* n, Func* func, const ExprPList& args);
+
 // Built-ins return true if able to compile the call, false if not.
 bool BuiltIn_Analyzer__name(const NameExpr* n, const ExprPList& args);
 bool BuiltIn_Broker__flush_logs(const NameExpr* n, const ExprPList& args);
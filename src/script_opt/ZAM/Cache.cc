@@ -0,0 +1,1090 @@
+// See the file "COPYING" in the main distribution directory for copyright.
+
+#include "zeek/script_opt/ZAM/Cache.h"
+
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utime.h>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <set>
+#include <sstream>
+
+#include "zeek/Desc.h"
+#include "zeek/EventRegistry.h"
+#include "zeek/IPAddr.h"
+#include "zeek/Reporter.h"
+#include "zeek/SerializationFormat.h"
+#include "zeek/ZeekString.h"
+#include "zeek/plugin/Manager.h"
+#include "zeek/script_opt/ZAM/Compile.h"
+
+namespace zeek
+	{
+extern const char* zeek_version();
+	}
+
+namespace zeek::detail
+	{
+
+// Bump whenever the layout of the cache file, or of ZAM instructions
+// and their auxiliary information, changes.
+static constexpr uint32_t ZAM_CACHE_VERSION = 1;
+static constexpr const char* ZAM_CACHE_MAGIC = "ZAM-cache";
+
+// How long a cache file can go unused before RemoveStale() deletes it.
+// Generous enough to keep the files of cluster nodes that load different
+// scripts and of configurations that are switched between.
+static constexpr time_t ZAM_CACHE_MAX_AGE = 7 * 24 * 60 * 60;
+
+// Whether instructions with the given operand type carry a constant.
+// ConstVal() tells us based on the operand type alone, so probe it with
+// an empty constant of a type that can't hold a managed value.
+static bool has_const_operand(const ZInst& z)
+	{
+	ZInst probe(z.op, z.op_type);
+	probe.t = base_type(TYPE_COUNT);
+	return probe.ConstVal() != nullptr;
+	}
+
+// Switch tables map case values to instruction numbers.  "W" is the
+// type used to serialize the case values.
+template <typename W, typename T>
+static void write_cases(SerializationFormat* fmt, const CaseMaps<T>& cases)
+	{
+	fmt->Write(static_cast<uint32_t>(cases.size()), "num-case-maps");
+
+	for ( const auto& cm : cases )
+		{
+		fmt->Write(static_cast<uint32_t>(cm.size()), "num-cases");
+
+		for ( const auto& c : cm )
+			{
+			fmt->Write(static_cast<W>(c.first), "case");
+			fmt->Write(c.second, "target");
+			}
+		}
+	}
+
+template <typename W, typename T>
+static bool read_cases(SerializationFormat* fmt, CaseMaps<T>* cases)
+	{
+	uint32_t n;
+	if ( ! fmt->Read(&n, "num-case-maps") )
+		return false;
+
+	cases->resize(n);
+
+	for ( auto& cm : *cases )
+		{
+		if ( ! fmt->Read(&n, "num-cases") )
+			return false;
+
+		for ( auto i = 0U; i < n; ++i )
+			{
+			W c;
+			int target;
+			if ( ! fmt->Read(&c, "case") || ! fmt->Read(&target, "target") )
+				return false;
+
+			cm[static_cast<T>(c)] = target;
+			}
+		}
+
+	return true;
+	}
+
+// How types are represented in the cache.
+enum CachedTypeKind
+	{
+	CT_NONE,
+	CT_BASE,
+	CT_NAMED,
+	CT_VECTOR,
+	CT_TABLE,
+	CT_SET,
+	CT_LIST,
+	};
+
+static p_hash_type cache_key(const std::vector<FuncInfo>& funcs)
+	{
+	p_hash_type h = p_hash(zeek_version());
+	h = merge_p_hashes(h, p_hash(static_cast<int>(ZAM_CACHE_VERSION)));
+	h = merge_p_hashes(h, p_hash(OP_NOP));
+
+	auto& ao = analysis_options;
+	int opts = (ao.inliner ? 1 : 0) | (ao.optimize_AST ? 2 : 0) | (ao.no_ZAM_opt ? 4 : 0) |
+	           (ao.compile_all ? 8 : 0);
+
+	// Whether BiFs get called directly depends on the loaded plugins.
+	if ( plugin_mgr->HavePluginForHook(plugin::HOOK_CALL_FUNCTION) )
+		opts |= 16;
+
+	h = merge_p_hashes(h, p_hash(opts));
+
+	// The profile hashes capture the shape of each body, and the
+	// descriptions the details they omit, such as operator order.
+	// The locations keep run-time error messages accurate when a
+	// script merely moves around.
+	for ( auto& f : funcs )
+		{
+		auto body = f.Body().get();
+		auto loc = body->GetLocationInfo();
+
+		h = merge_p_hashes(h, p_hash(f.Func()->Name()));
+		h = merge_p_hashes(h, f.Profile()->HashVal());
+		h = merge_p_hashes(h, p_hash(obj_desc(body)));
+		h = merge_p_hashes(h, p_hash(loc->filename ? loc->filename : ""));
+		h = merge_p_hashes(h, p_hash(loc->first_line));
+		h = merge_p_hashes(h, p_hash(loc->last_line));
+		}
+
+	// Enum constants and switch cases are stored by their numeric
+	// values, which depend on the order in which scripts add names.
+	for ( const auto& id : global_scope()->OrderedVars() )
+		{
+		if ( ! id->IsType() || id->GetType()->Tag() != TYPE_ENUM )
+			continue;
+
+		h = merge_p_hashes(h, p_hash(id->Name()));
+
+		for ( const auto& [name, val] : id->GetType()->AsEnumType()->Names() )
+			{
+			h = merge_p_hashes(h, p_hash(name));
+			h = merge_p_hashes(h, p_hash(static_cast<int>(val)));
+			}
+		}
+
+	// Constant folding pulls in the values of global constants.
+	for ( const auto& id : global_scope()->OrderedVars() )
+		{
+		if ( ! id->IsConst() || ! id->GetVal() || ! is_atomic_type(id->GetType()) )
+			continue;
+
+		h = merge_p_hashes(h, p_hash(id->Name()));
+		h = merge_p_hashes(h, p_hash(obj_desc(id->GetVal().get())));
+		}
+
+	return h;
+	}
+
+ZAMCache::ZAMCache(const std::string& arg_dir, const std::vector<FuncInfo>& funcs) : dir(arg_dir)
+	{
+	file_name = util::fmt("%s/zam-%016llx.cache", dir.c_str(), cache_key(funcs));
+	}
+
+bool ZAMCache::Load()
+	{
+	std::ifstream in(file_name, std::ios::binary);
+	if ( ! in )
+		return false;
+
+	std::stringstream ss;
+	ss << in.rdbuf();
+	auto data = ss.str();
+
+	// Damaged files need to be ignored rather than aborting.
+	BinarySerializationFormat fmt;
+	fmt.SetQuiet();
+	fmt.StartRead(data.data(), data.size());
+
+	std::string magic;
+	uint32_t version;
+	uint32_t n;
+
+	if ( ! fmt.Read(&magic, "magic") || magic != ZAM_CACHE_MAGIC ||
+	     ! fmt.Read(&version, "version") || version != ZAM_CACHE_VERSION ||
+	     ! fmt.Read(&n, "num-entries") )
+		{
+		reporter->Warning("ignoring malformed ZAM cache file %s", file_name.c_str());
+		return false;
+		}
+
+	for ( auto i = 0U; i < n; ++i )
+		{
+		std::string name;
+		std::string body;
+
+		if ( ! fmt.Read(&name, "name") || ! fmt.Read(&body, "body") )
+			{
+			reporter->Warning("ignoring truncated ZAM cache file %s", file_name.c_str());
+			entries.clear();
+			return false;
+			}
+
+		entries[name] = std::move(body);
+		}
+
+	fmt.EndRead();
+
+	return ! entries.empty();
+	}
+
+void ZAMCache::Save()
+	{
+	if ( num_added == 0 )
+		return;
+
+	BinarySerializationFormat fmt;
+	fmt.StartWrite();
+
+	fmt.Write(ZAM_CACHE_MAGIC, "magic");
+	fmt.Write(ZAM_CACHE_VERSION, "version");
+	fmt.Write(static_cast<uint32_t>(entries.size()), "num-entries");
+
+	for ( const auto& e : entries )
+		{
+		fmt.Write(e.first, "name");
+		fmt.Write(e.second, "body");
+		}
+
+	char* data;
+	auto len = fmt.EndWrite(&data);
+
+	auto tmp_name = util::fmt("%s.%d.tmp", file_name.c_str(), getpid());
+	std::string tmp{tmp_name};
+
+	std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+	out.write(data, len);
+	out.close();
+	free(data);
+
+	if ( ! out || rename(tmp.c_str(), file_name.c_str()) < 0 )
+		{
+		reporter->Warning("could not write ZAM cache file %s: %s", file_name.c_str(),
+		                  strerror(errno));
+		unlink(tmp.c_str());
+		}
+	}
+
+void ZAMCache::RemoveStale()
+	{
+	// Fails harmlessly if there's no file because nothing was cacheable.
+	utime(file_name.c_str(), nullptr);
+
+	auto d = opendir(dir.c_str());
+	if ( ! d )
+		return;
+
+	auto now = time(nullptr);
+
+	while ( auto e = readdir(d) )
+		{
+		// Also catches temporary files left behind by crashed runs.
+		std::string name = e->d_name;
+		if ( name.compare(0, 4, "zam-") != 0 || name.find(".cache") == std::string::npos )
+			continue;
+
+		auto path = dir + "/" + name;
+		if ( path == file_name )
+			continue;
+
+		struct stat st;
+		if ( stat(path.c_str(), &st) < 0 || now - st.st_mtime < ZAM_CACHE_MAX_AGE )
+			continue;
+
+		if ( unlink(path.c_str()) < 0 )
+			reporter->Warning("could not remove stale ZAM cache file %s: %s", path.c_str(),
+			                  strerror(errno));
+		}
+
+	closedir(d);
+	}
+
+IntrusivePtr<ZBody> ZAMCache::Lookup(const std::string& name, ScriptFunc* f)
+	{
+	auto e = entries.find(name);
+	if ( e == entries.end() )
+		return nullptr;
+
+	BinarySerializationFormat fmt;
+	fmt.SetQuiet();
+	fmt.StartRead(e->second.data(), e->second.size());
+
+	int frame_size;
+	auto body = ReadBody(&fmt, f->Name(), &frame_size);
+
+	if ( ! body || ! fmt.ReadError().empty() )
+		{
+		// Something it refers to no longer resolves.  Compile it
+		// afresh, which will also replace the entry.
+		entries.erase(e);
+		return nullptr;
+		}
+
+	if ( frame_size > f->FrameSize() )
+		f->SetFrameSize(frame_size);
+
+	++num_hits;
+	return body;
+	}
+
+void ZAMCache::Add(const std::string& name, const ScriptFunc* f, const ZBody* body)
+	{
+	BinarySerializationFormat fmt;
+	fmt.StartWrite();
+
+	bool ok = WriteBody(&fmt, body, f->FrameSize());
+
+	char* data;
+	auto len = fmt.EndWrite(&data);
+
+	if ( ok )
+		{
+		entries[name] = std::string(data, len);
+		++num_added;
+		}
+
+	free(data);
+	}
+
+std::string ZAMCache::EntryName(const FuncInfo& f) const
+	{
+	// Different bodies of the same event or hook can only share
+	// a name if they're identical, in which case they also compile
+	// to the same code.
+	auto h = merge_p_hashes(f.Profile()->HashVal(), p_hash(obj_desc(f.Body().get())));
+	return util::fmt("%s#%016llx", f.Func()->Name(), h);
+	}
+
+bool ZAMCache::WriteBody(SerializationFormat* fmt, const ZBody* body, int frame_size) const
+	{
+	fmt->Write(frame_size, "interp-frame-size");
+	fmt->Write(body->fixed_frame != nullptr, "non-recursive");
+
+	fmt->Write(static_cast<uint32_t>(body->frame_denizens.size()), "num-denizens");
+	for ( const auto& d : body->frame_denizens )
+		{
+		fmt->Write(static_cast<uint32_t>(d.names.size()), "num-names");
+		for ( auto i = 0U; i < d.names.size(); ++i )
+			{
+			fmt->Write(d.names[i], "name");
+			fmt->Write(static_cast<uint64_t>(d.id_start[i]), "id-start");
+			}
+
+		fmt->Write(d.scope_end, "scope-end");
+		fmt->Write(d.is_managed, "is-managed");
+		}
+
+	fmt->Write(static_cast<uint32_t>(body->managed_slots.size()), "num-managed");
+	for ( auto s : body->managed_slots )
+		fmt->Write(s, "slot");
+
+	fmt->Write(static_cast<uint32_t>(body->globals.size()), "num-globals");
+	for ( const auto& g : body->globals )
+		{
+		if ( ! WriteGlobalID(fmt, g.id.get()) )
+			return false;
+
+		fmt->Write(g.slot, "slot");
+		}
+
+	fmt->Write(static_cast<uint32_t>(body->table_iters.size()), "num-table-iters");
+	fmt->Write(body->num_step_iters, "num-step-iters");
+
+	write_cases<int64_t>(fmt, body->int_cases);
+	write_cases<uint64_t>(fmt, body->uint_cases);
+	write_cases<double>(fmt, body->double_cases);
+	write_cases<std::string>(fmt, body->str_cases);
+
+	fmt->Write(body->ninst, "num-insts");
+	for ( auto i = 0U; i < body->ninst; ++i )
+		if ( ! WriteInst(fmt, body->insts[i]) )
+			return false;
+
+	return true;
+	}
+
+bool ZAMCache::WriteInst(SerializationFormat* fmt, const ZInst& z) const
+	{
+	// "when" conditions and attributes tie the instruction to
+	// AST elements that we have no way to find again.
+	if ( z.e || z.attrs )
+		return false;
+
+	fmt->Write(static_cast<int>(z.op), "op");
+	fmt->Write(static_cast<int>(z.op_type), "op-type");
+	fmt->Write(z.v1, "v1");
+	fmt->Write(z.v2, "v2");
+	fmt->Write(z.v3, "v3");
+	fmt->Write(z.v4, "v4");
+	fmt->Write(z.is_managed, "is-managed");
+
+	if ( ! WriteType(fmt, z.t) || ! WriteType(fmt, z.t2) )
+		return false;
+
+	if ( has_const_operand(z) )
+		{
+		auto c = z.ConstVal();
+		if ( ! c || ! WriteConst(fmt, c) )
+			return false;
+		}
+
+	if ( z.func )
+		{
+		auto& id = zeek::id::find(z.func->Name());
+		if ( ! id || ! id->GetVal() || id->GetType()->Tag() != TYPE_FUNC ||
+		     id->GetVal()->AsFunc() != z.func )
+			return false;
+
+		fmt->Write(true, "has-func");
+		fmt->Write(z.func->Name(), "func");
+		}
+	else
+		fmt->Write(false, "has-func");
+
+	if ( z.event_handler )
+		{
+		if ( event_registry->Lookup(z.event_handler->Name()) != z.event_handler )
+			return false;
+
+		fmt->Write(true, "has-handler");
+		fmt->Write(z.event_handler->Name(), "handler");
+		}
+	else
+		fmt->Write(false, "has-handler");
+
+	return WriteAux(fmt, z.aux) && WriteLocation(fmt, z.loc);
+	}
+
+bool ZAMCache::WriteAux(SerializationFormat* fmt, const ZInstAux* aux) const
+	{
+	fmt->Write(aux != nullptr, "has-aux");
+
+	if ( ! aux )
+		return true;
+
+	fmt->Write(aux->n, "n");
+	fmt->Write(aux->slots != nullptr, "has-slots");
+
+	for ( auto i = 0; i < aux->n; ++i )
+		{
+		fmt->Write(aux->ints[i], "int");
+
+		if ( ! WriteType(fmt, aux->types[i]) )
+			return false;
+
+		auto& c = aux->constants[i];
+		fmt->Write(c != nullptr, "has-const");
+
+		if ( c && (! WriteType(fmt, c->GetType()) || ! WriteConst(fmt, c)) )
+			return false;
+		}
+
+	if ( ! WriteGlobalID(fmt, aux->id_val) )
+		return false;
+
+	fmt->Write(aux->can_change_globals, "can-change-globals");
+
+	fmt->Write(static_cast<uint32_t>(aux->map.size()), "map-size");
+	for ( auto m : aux->map )
+		fmt->Write(m, "map");
+
+	fmt->Write(static_cast<uint32_t>(aux->loop_vars.size()), "num-loop-vars");
+	for ( auto i = 0U; i < aux->loop_vars.size(); ++i )
+		{
+		fmt->Write(aux->loop_vars[i], "loop-var");
+
+		if ( ! WriteType(fmt, aux->loop_var_types[i]) )
+			return false;
+		}
+
+	return WriteType(fmt, aux->value_var_type);
+	}
+
+bool ZAMCache::WriteType(SerializationFormat* fmt, const TypePtr& t) const
+	{
+	if ( ! t )
+		return fmt->Write(static_cast<int>(CT_NONE), "type-kind");
+
+	const auto& name = t->GetName();
+	if ( ! name.empty() )
+		{
+		auto& id = zeek::id::find(name);
+		if ( id && id->IsType() && id->GetType().get() == t.get() )
+			{
+			fmt->Write(static_cast<int>(CT_NAMED), "type-kind");
+			return fmt->Write(name, "type-name");
+			}
+		}
+
+	auto tag = t->Tag();
+
+	switch ( tag )
+		{
+		case TYPE_VOID:
+		case TYPE_BOOL:
+		case TYPE_INT:
+		case TYPE_COUNT:
+		case TYPE_DOUBLE:
+		case TYPE_TIME:
+		case TYPE_INTERVAL:
+		case TYPE_STRING:
+		case TYPE_PATTERN:
+		case TYPE_PORT:
+		case TYPE_ADDR:
+		case TYPE_SUBNET:
+		case TYPE_ANY:
+			fmt->Write(static_cast<int>(CT_BASE), "type-kind");
+			return fmt->Write(static_cast<int>(tag), "type-tag");
+
+		case TYPE_VECTOR:
+			fmt->Write(static_cast<int>(CT_VECTOR), "type-kind");
+			return WriteType(fmt, t->Yield());
+
+		case TYPE_TABLE:
+			{
+			auto tt = t->AsTableType();
+			fmt->Write(static_cast<int>(tt->IsSet() ? CT_SET : CT_TABLE), "type-kind");
+			return WriteType(fmt, tt->GetIndices()) && (tt->IsSet() || WriteType(fmt, tt->Yield()));
+			}
+
+		case TYPE_LIST:
+			{
+			auto tl = t->AsTypeList();
+			fmt->Write(static_cast<int>(CT_LIST), "type-kind");
+
+			if ( ! WriteType(fmt, tl->GetPureType()) )
+				return false;
+
+			const auto& types = tl->GetTypes();
+			fmt->Write(static_cast<uint32_t>(types.size()), "num-types");
+			for ( const auto& lt : types )
+				if ( ! WriteType(fmt, lt) )
+					return false;
+
+			return true;
+			}
+
+		default:
+			// Anonymous records, enums, functions, files, opaques.
+			return false;
+		}
+	}
+
+bool ZAMCache::WriteConst(SerializationFormat* fmt, const ValPtr& v) const
+	{
+	switch ( v->GetType()->Tag() )
+		{
+		case TYPE_BOOL:
+		case TYPE_INT:
+		case TYPE_ENUM:
+			return fmt->Write(static_cast<int64_t>(v->InternalInt()), "int-val");
+
+		case TYPE_COUNT:
+		case TYPE_PORT:
+			return fmt->Write(static_cast<uint64_t>(v->InternalUnsigned()), "uint-val");
+
+		case TYPE_DOUBLE:
+		case TYPE_TIME:
+		case TYPE_INTERVAL:
+			return fmt->Write(v->InternalDouble(), "double-val");
+
+		case TYPE_STRING:
+			{
+			auto s = v->AsString();
+			return fmt->Write(reinterpret_cast<const char*>(s->Bytes()), s->Len(), "string-val");
+			}
+
+		case TYPE_ADDR:
+			return fmt->Write(v->AsAddr(), "addr-val");
+
+		case TYPE_SUBNET:
+			return fmt->Write(v->AsSubNet(), "subnet-val");
+
+		default:
+			return false;
+		}
+	}
+
+bool ZAMCache::WriteGlobalID(SerializationFormat* fmt, const ID* id) const
+	{
+	if ( ! id )
+		return fmt->Write(false, "has-id");
+
+	if ( ! id->IsGlobal() || zeek::id::find(id->Name()).get() != id )
+		return false;
+
+	fmt->Write(true, "has-id");
+	return fmt->Write(id->Name(), "id");
+	}
+
+bool ZAMCache::WriteLocation(SerializationFormat* fmt, const Location* loc) const
+	{
+	if ( ! loc )
+		return fmt->Write(false, "has-loc");
+
+	fmt->Write(true, "has-loc");
+	fmt->Write(loc->filename ? loc->filename : "", "filename");
+	fmt->Write(loc->first_line, "first-line");
+	fmt->Write(loc->last_line, "last-line");
+	fmt->Write(loc->first_column, "first-column");
+	return fmt->Write(loc->last_column, "last-column");
+	}
+
+IntrusivePtr<ZBody> ZAMCache::ReadBody(SerializationFormat* fmt, const char* func_name,
+                                       int* frame_size)
+	{
+	auto body = make_intrusive<ZBody>(func_name);
+	bool non_recursive;
+	uint32_t n;
+
+	if ( ! fmt->Read(frame_size, "interp-frame-size") ||
+	     ! fmt->Read(&non_recursive, "non-recursive") || ! fmt->Read(&n, "num-denizens") )
+		return nullptr;
+
+	body->frame_denizens.resize(n);
+	for ( auto& d : body->frame_denizens )
+		{
+		uint32_t num_names;
+		if ( ! fmt->Read(&num_names, "num-names") )
+			return nullptr;
+
+		for ( auto i = 0U; i < num_names; ++i )
+			{
+			std::string name;
+			uint64_t start;
+			if ( ! fmt->Read(&name, "name") || ! fmt->Read(&start, "id-start") )
+				return nullptr;
+
+			d.names.push_back(Intern(name));
+			d.id_start.push_back(start);
+			}
+
+		if ( ! fmt->Read(&d.scope_end, "scope-end") || ! fmt->Read(&d.is_managed, "is-managed") )
+			return nullptr;
+		}
+
+	body->frame_size = body->frame_denizens.size();
+
+	if ( ! fmt->Read(&n, "num-managed") )
+		return nullptr;
+
+	body->managed_slots.resize(n);
+	for ( auto& s : body->managed_slots )
+		if ( ! fmt->Read(&s, "slot") )
+			return nullptr;
+
+	if ( ! fmt->Read(&n, "num-globals") )
+		return nullptr;
+
+	for ( auto i = 0U; i < n; ++i )
+		{
+		const ID* id;
+		int slot;
+		if ( ! ReadGlobalID(fmt, &id) || ! id || ! fmt->Read(&slot, "slot") )
+			return nullptr;
+
+		body->globals.push_back({{NewRef{}, const_cast<ID*>(id)}, slot});
+		}
+
+	body->num_globals = body->globals.size();
+
+	if ( ! fmt->Read(&n, "num-table-iters") ||
+	     ! fmt->Read(&body->num_step_iters, "num-step-iters") )
+		return nullptr;
+
+	body->table_iters.resize(n);
+
+	if ( ! read_cases<int64_t>(fmt, &body->int_cases) ||
+	     ! read_cases<uint64_t>(fmt, &body->uint_cases) ||
+	     ! read_cases<double>(fmt, &body->double_cases) ||
+	     ! read_cases<std::string>(fmt, &body->str_cases) )
+		return nullptr;
+
+	if ( ! fmt->Read(&n, "num-insts") )
+		return nullptr;
+
+	std::vector<ZInst> insts(n);
+	std::vector<ZInst*> inst_ptrs;
+
+	for ( auto& z : insts )
+		{
+		if ( ! ReadInst(fmt, &z) )
+			{
+			for ( auto& zi : insts )
+				delete zi.aux;
+			return nullptr;
+			}
+
+		inst_ptrs.push_back(&z);
+		}
+
+	if ( non_recursive )
+		body->InitFixedFrame();
+
+	body->SetInsts(inst_ptrs);
+
+	return body;
+	}
+
+bool ZAMCache::ReadInst(SerializationFormat* fmt, ZInst* z)
+	{
+	int op;
+	int op_type;
+
+	if ( ! fmt->Read(&op, "op") || ! fmt->Read(&op_type, "op-type") || op < 0 || op > OP_NOP )
+		return false;
+
+	z->op = static_cast<ZOp>(op);
+	z->op_type = static_cast<ZAMOpType>(op_type);
+
+	if ( ! fmt->Read(&z->v1, "v1") || ! fmt->Read(&z->v2, "v2") || ! fmt->Read(&z->v3, "v3") ||
+	     ! fmt->Read(&z->v4, "v4") || ! fmt->Read(&z->is_managed, "is-managed") )
+		return false;
+
+	if ( ! ReadType(fmt, &z->t) || ! ReadType(fmt, &z->t2) )
+		return false;
+
+	if ( has_const_operand(*z) )
+		{
+		ValPtr c;
+		if ( ! z->t || ! ReadConst(fmt, z->t, &c) )
+			return false;
+
+		z->c = ZVal(c, z->t);
+		}
+
+	bool has_func;
+	if ( ! fmt->Read(&has_func, "has-func") )
+		return false;
+
+	if ( has_func )
+		{
+		std::string name;
+		if ( ! fmt->Read(&name, "func") )
+			return false;
+
+		auto& id = zeek::id::find(name);
+		if ( ! id || ! id->GetVal() || id->GetType()->Tag() != TYPE_FUNC )
+			return false;
+
+		z->func = id->GetVal()->AsFunc();
+		}
+
+	bool has_handler;
+	if ( ! fmt->Read(&has_handler, "has-handler") )
+		return false;
+
+	if ( has_handler )
+		{
+		std::string name;
+		if ( ! fmt->Read(&name, "handler") )
+			return false;
+
+		z->event_handler = event_registry->Lookup(name);
+		if ( ! z->event_handler )
+			return false;
+		}
+
+	return ReadAux(fmt, &z->aux) && ReadLocation(fmt, &z->loc);
+	}
+
+bool ZAMCache::ReadAux(SerializationFormat* fmt, ZInstAux** aux_p)
+	{
+	bool has_aux;
+	if ( ! fmt->Read(&has_aux, "has-aux") )
+		return false;
+
+	if ( ! has_aux )
+		return true;
+
+	int n;
+	bool has_slots;
+	if ( ! fmt->Read(&n, "n") || ! fmt->Read(&has_slots, "has-slots") )
+		return false;
+
+	auto aux = new ZInstAux(n);
+	*aux_p = aux;
+
+	if ( ! has_slots )
+		aux->slots = nullptr;
+
+	for ( auto i = 0; i < n; ++i )
+		{
+		bool has_const;
+		if ( ! fmt->Read(&aux->ints[i], "int") || ! ReadType(fmt, &aux->types[i]) ||
+		     ! fmt->Read(&has_const, "has-const") )
+			return false;
+
+		if ( has_const )
+			{
+			TypePtr ct;
+			if ( ! ReadType(fmt, &ct) || ! ct || ! ReadConst(fmt, ct, &aux->constants[i]) )
+				return false;
+			}
+		}
+
+	if ( ! ReadGlobalID(fmt, &aux->id_val) ||
+	     ! fmt->Read(&aux->can_change_globals, "can-change-globals") )
+		return false;
+
+	uint32_t num;
+	if ( ! fmt->Read(&num, "map-size") )
+		return false;
+
+	aux->map.resize(num);
+	for ( auto& m : aux->map )
+		if ( ! fmt->Read(&m, "map") )
+			return false;
+
+	if ( ! fmt->Read(&num, "num-loop-vars") )
+		return false;
+
+	aux->loop_vars.resize(num);
+	aux->loop_var_types.resize(num);
+	for ( auto i = 0U; i < num; ++i )
+		if ( ! fmt->Read(&aux->loop_vars[i], "loop-var") ||
+		     ! ReadType(fmt, &aux->loop_var_types[i]) )
+			return false;
+
+	return ReadType(fmt, &aux->value_var_type);
+	}
+
+bool ZAMCache::ReadType(SerializationFormat* fmt, TypePtr* t)
+	{
+	int kind;
+	if ( ! fmt->Read(&kind, "type-kind") )
+		return false;
+
+	switch ( kind )
+		{
+		case CT_NONE:
+			*t = nullptr;
+			return true;
+
+		case CT_BASE:
+			{
+			int tag;
+			if ( ! fmt->Read(&tag, "type-tag") || tag < 0 || tag >= NUM_TYPES )
+				return false;
+
+			*t = base_type(static_cast<TypeTag>(tag));
+			return true;
+			}
+
+		case CT_NAMED:
+			{
+			std::string name;
+			if ( ! fmt->Read(&name, "type-name") )
+				return false;
+
+			auto& id = zeek::id::find(name);
+			if ( ! id || ! id->IsType() )
+				return false;
+
+			*t = id->GetType();
+			return true;
+			}
+
+		case CT_VECTOR:
+			{
+			TypePtr yield;
+			if ( ! ReadType(fmt, &yield) || ! yield )
+				return false;
+
+			*t = make_intrusive<VectorType>(std::move(yield));
+			return true;
+			}
+
+		case CT_TABLE:
+		case CT_SET:
+			{
+			TypePtr indices;
+			if ( ! ReadType(fmt, &indices) || ! indices || indices->Tag() != TYPE_LIST )
+				return false;
+
+			auto tl = cast_intrusive<TypeList>(indices);
+
+			if ( kind == CT_SET )
+				{
+				*t = make_intrusive<SetType>(std::move(tl), nullptr);
+				return true;
+				}
+
+			TypePtr yield;
+			if ( ! ReadType(fmt, &yield) || ! yield )
+				return false;
+
+			*t = make_intrusive<TableType>(std::move(tl), std::move(yield));
+			return true;
+			}
+
+		case CT_LIST:
+			{
+			TypePtr pure;
+			uint32_t n;
+			if ( ! ReadType(fmt, &pure) || ! fmt->Read(&n, "num-types") )
+				return false;
+
+			auto tl = make_intrusive<TypeList>(std::move(pure));
+			for ( auto i = 0U; i < n; ++i )
+				{
+				TypePtr lt;
+				if ( ! ReadType(fmt, &lt) || ! lt )
+					return false;
+
+				tl->AppendEvenIfNotPure(std::move(lt));
+				}
+
+			*t = std::move(tl);
+			return true;
+			}
+
+		default:
+			return false;
+		}
+	}
+
+bool ZAMCache::ReadConst(SerializationFormat* fmt, const TypePtr& t, ValPtr* v)
+	{
+	switch ( t->Tag() )
+		{
+		case TYPE_BOOL:
+		case TYPE_INT:
+		case TYPE_ENUM:
+			{
+			int64_t i;
+			if ( ! fmt->Read(&i, "int-val") )
+				return false;
+
+			if ( t->Tag() == TYPE_BOOL )
+				*v = val_mgr->Bool(i != 0);
+			else if ( t->Tag() == TYPE_INT )
+				*v = val_mgr->Int(i);
+			else
+				*v = t->AsEnumType()->GetEnumVal(i);
+
+			return true;
+			}
+
+		case TYPE_COUNT:
+		case TYPE_PORT:
+			{
+			uint64_t u;
+			if ( ! fmt->Read(&u, "uint-val") )
+				return false;
+
+			if ( t->Tag() == TYPE_COUNT )
+				*v = val_mgr->Count(u);
+			else
+				*v = val_mgr->Port(static_cast<uint32_t>(u));
+
+			return true;
+			}
+
+		case TYPE_DOUBLE:
+		case TYPE_TIME:
+		case TYPE_INTERVAL:
+			{
+			double d;
+			if ( ! fmt->Read(&d, "double-val") )
+				return false;
+
+			if ( t->Tag() == TYPE_DOUBLE )
+				*v = make_intrusive<DoubleVal>(d);
+			else if ( t->Tag() == TYPE_TIME )
+				*v = make_intrusive<TimeVal>(d);
+			else
+				*v = make_intrusive<IntervalVal>(d, Seconds);
+
+			return true;
+			}
+
+		case TYPE_STRING:
+			{
+			std::string s;
+			if ( ! fmt->Read(&s, "string-val") )
+				return false;
+
+			*v = make_intrusive<StringVal>(s.size(), s.data());
+			return true;
+			}
+
+		case TYPE_ADDR:
+			{
+			IPAddr a;
+			if ( ! fmt->Read(&a, "addr-val") )
+				return false;
+
+			*v = make_intrusive<AddrVal>(a);
+			return true;
+			}
+
+		case TYPE_SUBNET:
+			{
+			IPPrefix p;
+			if ( ! fmt->Read(&p, "subnet-val") )
+				return false;
+
+			*v = make_intrusive<SubNetVal>(p);
+			return true;
+			}
+
+		default:
+			return false;
+		}
+	}
+
+bool ZAMCache::ReadGlobalID(SerializationFormat* fmt, const ID** id)
+	{
+	bool has_id;
+	if ( ! fmt->Read(&has_id, "has-id") )
+		return false;
+
+	if ( ! has_id )
+		{
+		*id = nullptr;
+		return true;
+		}
+
+	std::string name;
+	if ( ! fmt->Read(&name, "id") )
+		return false;
+
+	*id = zeek::id::find(name).get();
+	return *id != nullptr;
+	}
+
+bool ZAMCache::ReadLocation(SerializationFormat* fmt, const Location** loc)
+	{
+	bool has_loc;
+	if ( ! fmt->Read(&has_loc, "has-loc") )
+		return false;
+
+	if ( ! has_loc )
+		{
+		*loc = nullptr;
+		return true;
+		}
+
+	std::string filename;
+	auto l = new Location();
+
+	if ( ! fmt->Read(&filename, "filename") || ! fmt->Read(&l->first_line, "first-line") ||
+	     ! fmt->Read(&l->last_line, "last-line") ||
+	     ! fmt->Read(&l->first_column, "first-column") ||
+	     ! fmt->Read(&l->last_column, "last-column") )
+		{
+		delete l;
+		return false;
+		}
+
+	// Like the locations of the AST nodes they stand in for, these
+	// live for the remainder of the run.
+	l->filename = Intern(filename);
+	*loc = l;
+
+	return true;
+	}
+
+const char* ZAMCache::Intern(const std::string& s)
+	{
+	static std::set<std::string> strings;
+	return strings.insert(s).first->c_str();
+	}
+
+	} // namespace zeek::detail
@@ -0,0 +1,104 @@
+// See the file "COPYING" in the main distribution directory for copyright.
+
+// Persistent cache of compiled ZAM function bodies, so that a subsequent
+// run over the same scripts can skip reduction, AST optimization and ZAM
+// compilation for every body it finds there.
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+
+#include "zeek/script_opt/ProfileFunc.h"
+#include "zeek/script_opt/ScriptOpt.h"
+#include "zeek/script_opt/ZAM/ZBody.h"
+
+namespace zeek::detail
+	{
+
+class SerializationFormat;
+
+// A cache file holds the bodies compiled for one particular set of parsed
+// scripts.  Its name includes a hash computed across all of the script
+// functions (which reflects inlining, since that can pull in code from
+// anywhere), the values of global constants (which the optimizer folds),
+// the numbering of enums (as their values are stored as numbers), the Zeek
+// version and the optimization options.  Any change to these thus simply
+// leads to a different file, and there's no need to worry about partially
+// stale entries.
+//
+// Bodies can only be cached if everything they refer to can be found
+// again by name when loading: globals, functions, event handlers, and
+// named types.  Bodies that use anonymous record or function types,
+// attributes, or non-atomic constants are compiled afresh on each run.
+class ZAMCache
+	{
+public:
+	ZAMCache(const std::string& dir, const std::vector<FuncInfo>& funcs);
+
+	// Reads the cache file, if present.  Returns true if it had entries.
+	bool Load();
+
+	// Writes out the cache file if any compiled bodies were added since
+	// it was loaded.  The file is replaced atomically so that concurrent
+	// runs (e.g., cluster nodes starting up together) never see a
+	// partially written cache.
+	void Save();
+
+	// Removes cache files in the directory that no run has used for
+	// ZAM_CACHE_MAX_AGE, as every change to the scripts or options leaves
+	// the previous file behind.  Files are aged by modification time, so
+	// this first marks the current one as used.
+	void RemoveStale();
+
+	// Returns the name under which the given function body is stored.
+	// Needs to be computed before optimization alters the body.
+	std::string EntryName(const FuncInfo& f) const;
+
+	// Returns a ZBody for the function body with the given entry name
+	// if present in the cache, or nil if not.  On success, also adjusts
+	// the interpreter frame size of the function to what the compiled
+	// body requires.
+	IntrusivePtr<ZBody> Lookup(const std::string& name, ScriptFunc* f);
+
+	// Adds a freshly compiled body to the cache.  Silently ignores
+	// bodies that cannot be cached.
+	void Add(const std::string& name, const ScriptFunc* f, const ZBody* body);
+
+	// Number of bodies found in / added to the cache.
+	int NumHits() const { return num_hits; }
+	int NumAdded() const { return num_added; }
+
+private:
+	bool WriteBody(SerializationFormat* fmt, const ZBody* body, int frame_size) const;
+	bool WriteInst(SerializationFormat* fmt, const ZInst& z) const;
+	bool WriteAux(SerializationFormat* fmt, const ZInstAux* aux) const;
+	bool WriteType(SerializationFormat* fmt, const TypePtr& t) const;
+	bool WriteConst(SerializationFormat* fmt, const ValPtr& v) const;
+	bool WriteGlobalID(SerializationFormat* fmt, const ID* id) const;
+	bool WriteLocation(SerializationFormat* fmt, const Location* loc) const;
+
+	IntrusivePtr<ZBody> ReadBody(SerializationFormat* fmt, const char* func_name,
+	                             int* frame_size);
+	bool ReadInst(SerializationFormat* fmt, ZInst* z);
+	bool ReadAux(SerializationFormat* fmt, ZInstAux** aux);
+	bool ReadType(SerializationFormat* fmt, TypePtr* t);
+	bool ReadConst(SerializationFormat* fmt, const TypePtr& t, ValPtr* v);
+	bool ReadGlobalID(SerializationFormat* fmt, const ID** id);
+	bool ReadLocation(SerializationFormat* fmt, const Location** loc);
+
+	// Returns a copy of the given string that lives for the rest of the
+	// run, as needed for frame denizen names and locations.
+	const char* Intern(const std::string& s);
+
+	std::string dir;
+	std::string file_name;
+
+	// Serialized bodies, indexed by EntryName().
+	std::unordered_map<std::string, std::string> entries;
+
+	int num_hits = 0;
+	int num_added = 0;
+	};
+
+	} // namespace zeek::detail
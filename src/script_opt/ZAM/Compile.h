@@ -404,6 +404,10 @@ private:
 	// pruned.
 	bool PruneUnused();
 
+	// Combine particular pairs of adjacent instructions into single
+	// "superinstructions".  True if something got combined.
+	bool FuseInsts();
+
 	// For the current state of insts1, compute lifetimes of frame
 	// denizens (variable(s) using a given frame slot) in terms of
 	// first-instruction-to-last-instruction during which they're
@@ -351,6 +351,24 @@ const ZAMStmt ZAMCompiler::CompileEvent(EventHandler* h, const ListExpr* l)
 			break;
 			}
 
+	// If the arguments have exactly the types of the handler's
+	// parameters, they can be passed along as ZVals, which avoids
+	// converting them to Val's if the handler is compiled, too.
+	const auto& ft = h->GetType();
+	bool zval_args = n > 0 && ft && ft->ParamList()->GetTypes().size() == n;
+
+	for ( auto i = 0U; zval_args && i < n; ++i )
+		if ( ! same_type(exprs[i]->GetType(), ft->ParamList()->GetTypes()[i]) )
+			zval_args = false;
+
+	if ( zval_args )
+		{
+		ZInstI z(OP_EVENT_ZVALS_X);
+		z.aux = InternalBuildVals(l);
+		z.event_handler = h;
+		return AddInst(z);
+		}
+
 	if ( n > 4 || ! all_vars )
 		{ // do generic form
 		ZInstI z(OP_EVENT_HL);
@@ -623,6 +623,16 @@ void ZAM_OpTemplate::InstantiateEval(EmitTarget et, const string& op_suffix, con
 	auto op_code = g->GenOpCode(this, "_" + op_suffix, zc);
 
 	EmitTo(et);
+
+	if ( et == Eval )
+		{
+		BeginEvalCase(op_code);
+		Emit(eval);
+		EndEvalCase();
+		NL();
+		return;
+		}
+
 	Emit("case " + op_code + ":");
 	BeginBlock();
 	Emit(eval);
@@ -631,6 +641,22 @@ void ZAM_OpTemplate::InstantiateEval(EmitTarget et, const string& op_suffix, con
 	NL();
 	}
 
+void ZAM_OpTemplate::BeginEvalCase(const string& op_code)
+	{
+	g->Emit(EvalLabels, "ZAM_OP_ADDR(" + op_code + ");");
+
+	Emit("case " + op_code + ":");
+	Emit("ZAM_OP_LABEL(" + op_code + ")");
+	BeginBlock();
+	Emit("ZAM_OP_START");
+	}
+
+void ZAM_OpTemplate::EndEvalCase()
+	{
+	EndBlock();
+	EmitUp("ZAM_OP_NEXT");
+	}
+
 void ZAM_OpTemplate::InstantiateAssignOp(const vector<ZAM_OperandType>& ot, const string& suffix)
 	{
 	// First, create a generic version of the operand, which the
@@ -659,11 +685,9 @@ void ZAM_OpTemplate::InstantiateAssignOp(const vector<ZAM_OperandType>& ot, cons
 			}
 
 		EmitTo(Eval);
-		Emit("case " + op + ":");
-		BeginBlock();
+		BeginEvalCase(op);
 		GenAssignOpCore(ot, eval, ti.accessor, ti.is_managed);
-		Emit("break;");
-		EndBlock();
+		EndEvalCase();
 		}
 	}
 
@@ -1408,7 +1432,7 @@ void ZAM_ExprOpTemplate::InstantiateEval(const vector<ZAM_OperandType>& ot_orig,
 		else if ( zc == ZIC_COND )
 			{ // Aesthetics: get rid of trailing newlines.
 			eval = regex_replace(eval, regex("\n"), "");
-			eval = "if ( ! (" + eval + ") ) " + "{ pc = " + branch_target + "; continue; }";
+			eval = "if ( ! (" + eval + ") ) " + "ZAM_GOTO(" + branch_target + ")";
 			}
 
 		else if ( ! is_none && (ei.IsDefault() || IsConditionalOp()) )
@@ -2058,6 +2082,7 @@ void ZAMGen::InitEmitTargets()
 		{Cond, "ZAM-Conds.h"},
 		{DirectDef, "ZAM-DirectDefs.h"},
 		{Eval, "ZAM-EvalDefs.h"},
+		{EvalLabels, "ZAM-EvalLabels.h"},
 		{EvalMacros, "ZAM-EvalMacros.h"},
 		{MethodDecl, "ZAM-MethodDecls.h"},
 		{MethodDef, "ZAM-MethodDefs.h"},
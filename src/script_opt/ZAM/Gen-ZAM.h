@@ -139,6 +139,11 @@ enum EmitTarget
 	// #define's used to provide the templator's macro functionality.
 	EvalMacros,
 
+	// Initializations of the table that maps each ZAM instruction to
+	// the address of its case in the execution loop, used for
+	// direct-threaded dispatch.
+	EvalLabels,
+
 	// Switch cases the provide the C++ code for executing unary
 	// and binary vector operations.
 	Vec1Eval,
@@ -421,6 +426,12 @@ protected:
 	void InstantiateEval(EmitTarget et, const string& op_suffix, const string& eval,
 	                     ZAM_InstClass zc);
 
+	// Generates the beginning/end of the case statement for evaluating
+	// the given operation in ZBody's main execution loop.  These include
+	// the hooks used for direct-threaded dispatch (see ZBody.cc).
+	void BeginEvalCase(const string& op_code);
+	void EndEvalCase();
+
 	// Generates a set of assignment C++ evaluations, one per each
 	// possible Zeek scripting type of operand.
 	void InstantiateAssignOp(const vector<ZAM_OperandType>& ot, const string& suffix);
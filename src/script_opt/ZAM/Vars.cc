@@ -30,15 +30,9 @@ void ZAMCompiler::LoadParam(const ID* id)
 		reporter->InternalError(
 			"don't know how to compile local variable that's a type not a value");
 
-	bool is_any = IsAny(id->GetType());
-
-	ZOp op;
-
-	op = AssignmentFlavor(OP_LOAD_VAL_VV, id->GetType()->Tag());
-
 	int slot = AddToFrame(id);
 
-	ZInstI z(op, slot, id->Offset());
+	ZInstI z(OP_LOAD_PARAM_VV, slot, id->Offset());
 	z.SetType(id->GetType());
 	z.op_type = OP_VV_FRAME;
 
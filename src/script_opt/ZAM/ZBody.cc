@@ -28,6 +28,66 @@ namespace zeek::detail
 
 using std::vector;
 
+// When the compiler supports taking the address of a label, the main
+// execution loop dispatches directly from the end of each instruction
+// to the code for the next one ("direct threading"), rather than going
+// back through the loop and its switch.  Besides saving a jump and the
+// bounds check on the opcode, this gives each instruction its own
+// indirect branch, which CPUs predict much better than the single one
+// of the switch.  Defining ZAM_NO_COMPUTED_GOTO keeps the plain switch.
+#if (defined(__GNUC__) || defined(__clang__)) && ! defined(ZAM_NO_COMPUTED_GOTO)
+#define ZAM_COMPUTED_GOTO
+#endif
+
+#ifdef ZAM_COMPUTED_GOTO
+
+// Each case in the generated ZAM-EvalDefs.h starts with a label, and
+// ZAM-EvalLabels.h records the address of each of these.  As a threaded
+// jump bypasses the top of the loop, each case also refreshes "z".
+#define ZAM_OP_LABEL(op) L_##op:
+#define ZAM_OP_ADDR(op) op_labels[op] = &&L_##op
+#define ZAM_OP_START const auto& z = insts[pc];
+
+// Continues execution at the given PC, checking the same conditions as
+// the main loop.  When not threading, this goes back to the top of the
+// loop, like branches in the switch-based loop do.
+#define ZAM_GOTO(new_pc)                                                                           \
+	{                                                                                              \
+	pc = (new_pc);                                                                                 \
+	if ( ZAM_THREADED && pc < end_pc && ! ZAM_error )                                              \
+		goto* op_labels[insts[pc].op];                                                             \
+	continue;                                                                                      \
+	}
+
+// Continues with the next instruction.  When profiling, we don't thread,
+// and instead fall through to the bottom of the loop so the profiling
+// there accounts for the instruction before the PC gets incremented.
+#define ZAM_OP_NEXT                                                                                \
+	{                                                                                              \
+	if ( ZAM_THREADED )                                                                            \
+		ZAM_GOTO(pc + 1)                                                                           \
+	break;                                                                                         \
+	}
+
+#ifdef DEBUG
+#define ZAM_THREADED (! do_profile)
+#else
+#define ZAM_THREADED true
+#endif
+
+#else
+
+#define ZAM_OP_LABEL(op)
+#define ZAM_OP_START
+#define ZAM_GOTO(new_pc)                                                                           \
+	{                                                                                              \
+	pc = (new_pc);                                                                                 \
+	continue;                                                                                      \
+	}
+#define ZAM_OP_NEXT break;
+
+#endif
+
 static bool did_init = false;
 
 // Count of how often each type of ZOP executed, and how much CPU it
@@ -131,6 +191,25 @@ double curr_CPU_time()
 	return double(ts.tv_sec) + double(ts.tv_nsec) / 1e9;
 	}
 
+// It's a little weird doing this in body constructors, but unless
+// we add a general "initialize for ZAM" function, this is as good
+// a place as any.
+static void init_ZAM_globals()
+	{
+	if ( ! did_init )
+		{
+		auto log_ID_type = lookup_ID("ID", "Log");
+		ASSERT(log_ID_type);
+		log_ID_enum_type = log_ID_type->GetType<EnumType>();
+
+		any_base_type = base_type(TYPE_ANY);
+
+		ZVal::SetZValNilStatusAddr(&ZAM_error);
+
+		did_init = false;
+		}
+	}
+
 ZBody::ZBody(const char* _func_name, const ZAMCompiler* zc) : Stmt(STMT_ZAM)
 	{
 	func_name = _func_name;
@@ -154,31 +233,22 @@ ZBody::ZBody(const char* _func_name, const ZAMCompiler* zc) : Stmt(STMT_ZAM)
 	str_cases = zc->GetCases<std::string>();
 
 	if ( zc->NonRecursive() )
-		{
-		fixed_frame = new ZVal[frame_size];
-
-		for ( auto& ms : managed_slots )
-			fixed_frame[ms].ClearManagedVal();
-		}
+		InitFixedFrame();
 
 	table_iters = zc->GetTableIters();
 	num_step_iters = zc->NumStepIters();
 
-	// It's a little weird doing this in the constructor, but unless
-	// we add a general "initialize for ZAM" function, this is as good
-	// a place as any.
-	if ( ! did_init )
-		{
-		auto log_ID_type = lookup_ID("ID", "Log");
-		ASSERT(log_ID_type);
-		log_ID_enum_type = log_ID_type->GetType<EnumType>();
-
-		any_base_type = base_type(TYPE_ANY);
+	init_ZAM_globals();
+	}
 
-		ZVal::SetZValNilStatusAddr(&ZAM_error);
+ZBody::ZBody(const char* _func_name) : Stmt(STMT_ZAM)
+	{
+	func_name = _func_name;
+	frame_size = 0;
+	num_step_iters = 0;
+	num_globals = 0;
 
-		did_init = false;
-		}
+	init_ZAM_globals();
 	}
 
 ZBody::~ZBody()
@@ -199,6 +269,7 @@ void ZBody::SetInsts(vector<ZInst*>& _insts)
 
 	insts = insts_copy;
 
+	CheckZValArgs();
 	InitProfile();
 	}
 
@@ -217,9 +288,36 @@ void ZBody::SetInsts(vector<ZInstI*>& instsI)
 
 	insts = insts_copy;
 
+	CheckZValArgs();
 	InitProfile();
 	}
 
+void ZBody::InitFixedFrame()
+	{
+	fixed_frame = new ZVal[frame_size];
+
+	for ( auto& ms : managed_slots )
+		fixed_frame[ms].ClearManagedVal();
+	}
+
+void ZBody::CheckZValArgs()
+	{
+	// Triggers for "when" statements get the interpreter frame, and
+	// their conditions can refer to the parameters there.
+	for ( auto i = 0U; i < ninst; ++i )
+		switch ( insts[i].op )
+			{
+			case OP_WHEN_VVVV:
+			case OP_WHEN_VVVC:
+			case OP_WHEN_VV:
+				accepts_zval_args = false;
+				return;
+
+			default:
+				break;
+			}
+	}
+
 void ZBody::InitProfile()
 	{
 	if ( analysis_options.profile_ZAM )
@@ -253,7 +351,23 @@ ValPtr ZBody::Exec(Frame* f, StmtFlowType& flow)
 	return val;
 	}
 
-ValPtr ZBody::DoExec(Frame* f, int start_pc, StmtFlowType& flow)
+ValPtr ZBody::ExecWithArgs(Frame* f, const ZVal* args, StmtFlowType& flow)
+	{
+#ifdef DEBUG
+	double t = analysis_options.profile_ZAM ? curr_CPU_time() : 0.0;
+#endif
+
+	auto val = DoExec(f, 0, flow, args);
+
+#ifdef DEBUG
+	if ( analysis_options.profile_ZAM )
+		*CPU_time += curr_CPU_time() - t;
+#endif
+
+	return val;
+	}
+
+ValPtr ZBody::DoExec(Frame* f, int start_pc, StmtFlowType& flow, const ZVal* zargs)
 	{
 	int pc = start_pc;
 	const int end_pc = ninst;
@@ -291,6 +405,23 @@ ValPtr ZBody::DoExec(Frame* f, int start_pc, StmtFlowType& flow)
 
 	flow = FLOW_RETURN; // can be over-written by a Hook-Break
 
+#ifdef ZAM_COMPUTED_GOTO
+	// Address of the code for each ZAM instruction, set up on first use.
+	static const void* op_labels[OP_NOP + 1];
+	static bool did_label_init = false;
+
+	if ( ! did_label_init )
+		{
+		for ( auto& l : op_labels )
+			l = &&L_bad_op;
+
+		ZAM_OP_ADDR(OP_NOP);
+#include "ZAM-EvalLabels.h"
+
+		did_label_init = true;
+		}
+#endif
+
 	while ( pc < end_pc && ! ZAM_error )
 		{
 		auto& z = insts[pc];
@@ -312,7 +443,8 @@ ValPtr ZBody::DoExec(Frame* f, int start_pc, StmtFlowType& flow)
 		switch ( z.op )
 			{
 			case OP_NOP:
-				break;
+				ZAM_OP_LABEL(OP_NOP)
+				ZAM_OP_NEXT
 
 				// These must stay in this order or the build fails.
 				// clang-format off
@@ -321,6 +453,7 @@ ValPtr ZBody::DoExec(Frame* f, int start_pc, StmtFlowType& flow)
 				// clang-format on
 
 			default:
+				ZAM_OP_LABEL(bad_op)
 				reporter->InternalError("bad ZAM opcode");
 			}
 
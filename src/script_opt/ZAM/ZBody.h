@@ -31,6 +31,10 @@ class ZBody : public Stmt
 public:
 	ZBody(const char* _func_name, const ZAMCompiler* zc);
 
+	// Creates an empty body, to be populated by ZAMCache when
+	// loading a previously compiled one.
+	ZBody(const char* _func_name);
+
 	~ZBody() override;
 
 	// These are split out from the constructor to allow construction
@@ -41,6 +45,14 @@ public:
 
 	ValPtr Exec(Frame* f, StmtFlowType& flow) override;
 
+	// Executes the body with its parameters taken from the given ZVals
+	// rather than from the interpreter frame, which then needn't have
+	// them set.  Used for dispatching events raised by compiled scripts.
+	ValPtr ExecWithArgs(Frame* f, const ZVal* args, StmtFlowType& flow);
+
+	// Whether ExecWithArgs() can be used for this body.
+	bool AcceptsZValArgs() const { return accepts_zval_args; }
+
 	// Older code exists for save files, but let's see if we can
 	// avoid having to support them, as they're a fairly elaborate
 	// production.
@@ -53,11 +65,18 @@ public:
 
 protected:
 	friend class ZAMResumption;
+	friend class ZAMCache;
 
 	// Initializes profiling information, if needed.
 	void InitProfile();
 
-	ValPtr DoExec(Frame* f, int start_pc, StmtFlowType& flow);
+	// Allocates the fixed frame used by non-recursive functions.
+	void InitFixedFrame();
+
+	// Determines whether the body can execute using ZVal arguments.
+	void CheckZValArgs();
+
+	ValPtr DoExec(Frame* f, int start_pc, StmtFlowType& flow, const ZVal* zargs = nullptr);
 
 	// Run-time checking for "any" type being consistent with
 	// expected typed.  Returns true if the type match is okay.
@@ -95,6 +114,10 @@ private:
 	// for recursive ones this points to the local stack variable.
 	TableIterVec* tiv_ptr = &table_iters;
 
+	// True unless the body needs its parameters in the interpreter
+	// frame.
+	bool accepts_zval_args = true;
+
 	// Number of StepIterInfo's required by the function.  These we
 	// always create using a local stack variable, since they don't
 	// require any overhead or cleanup.
@@ -366,6 +366,21 @@ public:
 			vec.push_back(ToVal(frame, i));
 		}
 
+	// Returns the parallel arrays as ZVals, for direct calls to BiFs
+	// (see script_opt/DirectBiFs.h).  Constants are converted only the
+	// first time through.
+	const ZVal* ToZVals(const ZVal* frame)
+		{
+		if ( static_cast<int>(zvs.size()) != n )
+			InitZVals();
+
+		for ( auto i = 0; i < n; ++i )
+			if ( ! constants[i] )
+				zvs[i] = frame[slots[i]];
+
+		return zvs.data();
+		}
+
 	// When building up a ZInstAux, sets one element of the parallel
 	// arrays to a given frame slot and type.
 	void Add(int i, int slot, TypePtr t)
@@ -431,6 +446,27 @@ public:
 	// If we cared about memory penny-pinching, we could make this
 	// a pointer and only instantiate as needed.
 	ValVec vv;
+
+	// Same, for ToZVals().
+	std::vector<ZVal> zvs;
+
+private:
+	void InitZVals()
+		{
+		zvs.resize(n);
+
+		for ( auto i = 0; i < n; ++i )
+			if ( constants[i] )
+				{
+				// The ZVal borrows the reference held by
+				// "constants", which lives as long as we do.
+				const auto& t = constants[i]->GetType();
+				zvs[i] = ZVal(constants[i], t);
+
+				if ( ZVal::IsManagedType(t) )
+					Unref(zvs[i].ManagedVal());
+				}
+		}
 	};
 
 // Returns a human-readable version of the given ZAM op-code.
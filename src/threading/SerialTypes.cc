@@ -180,9 +180,22 @@ bool Value::Read(detail::SerializationFormat* fmt)
 	type = static_cast<TypeTag>(ty);
 	subtype = static_cast<TypeTag>(sty);
 
-	if ( ! present )
-		return true;
+	return ! present || ReadData(fmt, false);
+	}
+
+bool Value::ReadUntyped(detail::SerializationFormat* fmt, TypeTag arg_type, TypeTag arg_subtype)
+	{
+	type = arg_type;
+	subtype = arg_subtype;
+
+	if ( ! fmt->Read(&present, "present") )
+		return false;
+
+	return ! present || ReadData(fmt, true);
+	}
 
+bool Value::ReadData(detail::SerializationFormat* fmt, bool untyped)
+	{
 	switch ( type )
 		{
 		case TYPE_BOOL:
@@ -239,8 +252,8 @@ bool Value::Read(detail::SerializationFormat* fmt)
 					return fmt->Read(&val.addr_val.in.in6, "addr-in6");
 				}
 
-			// Can't be reached.
-			abort();
+			// Only reached with malformed input.
+			return false;
 			}
 
 		case TYPE_SUBNET:
@@ -264,8 +277,8 @@ bool Value::Read(detail::SerializationFormat* fmt)
 					return fmt->Read(&val.subnet_val.prefix.in.in6, "subnet-in6");
 				}
 
-			// Can't be reached.
-			abort();
+			// Only reached with malformed input.
+			return false;
 			}
 
 		case TYPE_DOUBLE:
@@ -281,16 +294,22 @@ bool Value::Read(detail::SerializationFormat* fmt)
 
 		case TYPE_TABLE:
 			{
-			if ( ! fmt->Read(&val.set_val.size, "set_size") )
+			// Each element takes at least one byte.
+			if ( ! fmt->Read(&val.set_val.size, "set_size") || val.set_val.size < 0 ||
+			     val.set_val.size > static_cast<bro_int_t>(fmt->BytesLeft()) )
+				{
+				val.set_val.size = 0;
 				return false;
+				}
 
-			val.set_val.vals = new Value*[val.set_val.size];
+			// Zeroed, so that the destructor copes with a partial read.
+			val.set_val.vals = new Value*[val.set_val.size]();
 
 			for ( bro_int_t i = 0; i < val.set_val.size; ++i )
 				{
-				val.set_val.vals[i] = new Value;
+				auto v = val.set_val.vals[i] = new Value;
 
-				if ( ! val.set_val.vals[i]->Read(fmt) )
+				if ( ! (untyped ? v->ReadUntyped(fmt, subtype, TYPE_VOID) : v->Read(fmt)) )
 					return false;
 				}
 
@@ -299,16 +318,22 @@ bool Value::Read(detail::SerializationFormat* fmt)
 
 		case TYPE_VECTOR:
 			{
-			if ( ! fmt->Read(&val.vector_val.size, "vector_size") )
+			// Each element takes at least one byte.
+			if ( ! fmt->Read(&val.vector_val.size, "vector_size") || val.vector_val.size < 0 ||
+			     val.vector_val.size > static_cast<bro_int_t>(fmt->BytesLeft()) )
+				{
+				val.vector_val.size = 0;
 				return false;
+				}
 
-			val.vector_val.vals = new Value*[val.vector_val.size];
+			// Zeroed, so that the destructor copes with a partial read.
+			val.vector_val.vals = new Value*[val.vector_val.size]();
 
 			for ( bro_int_t i = 0; i < val.vector_val.size; ++i )
 				{
-				val.vector_val.vals[i] = new Value;
+				auto v = val.vector_val.vals[i] = new Value;
 
-				if ( ! val.vector_val.vals[i]->Read(fmt) )
+				if ( ! (untyped ? v->ReadUntyped(fmt, subtype, TYPE_VOID) : v->Read(fmt)) )
 					return false;
 				}
 
@@ -316,7 +341,11 @@ bool Value::Read(detail::SerializationFormat* fmt)
 			}
 
 		default:
-			reporter->InternalError("unsupported type %s in Value::Read", type_name(type));
+			// Type tags come from the input, so this can happen with
+			// malformed data.  Make sure the destructor leaves the
+			// value alone.
+			present = false;
+			return false;
 		}
 
 	return false;
@@ -328,9 +357,19 @@ bool Value::Write(detail::SerializationFormat* fmt) const
 	        fmt->Write(present, "present")) )
 		return false;
 
-	if ( ! present )
-		return true;
+	return ! present || WriteData(fmt, false);
+	}
 
+bool Value::WriteUntyped(detail::SerializationFormat* fmt) const
+	{
+	if ( ! fmt->Write(present, "present") )
+		return false;
+
+	return ! present || WriteData(fmt, true);
+	}
+
+bool Value::WriteData(detail::SerializationFormat* fmt, bool untyped) const
+	{
 	switch ( type )
 		{
 		case TYPE_BOOL:
@@ -398,7 +437,9 @@ bool Value::Write(detail::SerializationFormat* fmt) const
 
 			for ( int i = 0; i < val.set_val.size; ++i )
 				{
-				if ( ! val.set_val.vals[i]->Write(fmt) )
+				auto v = val.set_val.vals[i];
+
+				if ( ! (untyped ? v->WriteUntyped(fmt) : v->Write(fmt)) )
 					return false;
 				}
 
@@ -412,7 +453,9 @@ bool Value::Write(detail::SerializationFormat* fmt) const
 
 			for ( int i = 0; i < val.vector_val.size; ++i )
 				{
-				if ( ! val.vector_val.vals[i]->Write(fmt) )
+				auto v = val.vector_val.vals[i];
+
+				if ( ! (untyped ? v->WriteUntyped(fmt) : v->Write(fmt)) )
 					return false;
 				}
 
@@ -420,7 +463,7 @@ bool Value::Write(detail::SerializationFormat* fmt) const
 			}
 
 		default:
-			reporter->InternalError("unsupported type %s in Value::Write", type_name(type));
+			reporter->InternalError("unsupported type %s in Value::WriteData", type_name(type));
 		}
 
 	// unreachable
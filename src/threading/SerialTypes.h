@@ -225,6 +225,31 @@ struct Value
 	 */
 	bool Write(zeek::detail::SerializationFormat* fmt) const;
 
+	/**
+	 * Unserializes a value written by WriteUntyped().
+	 *
+	 * @param fmt The serialization format to use. The format handles low-level I/O.
+	 *
+	 * @param type The type of the value, as the writer had it.
+	 *
+	 * @param subtype The subtype of the value for sets and vectors.
+	 *
+	 * @return False if an error occured.
+	 */
+	bool ReadUntyped(zeek::detail::SerializationFormat* fmt, TypeTag type, TypeTag subtype);
+
+	/**
+	 * Serializes a value without its type information, which is more
+	 * compact when the reader knows the type already, e.g. from the
+	 * fields of a log stream.
+	 *
+	 * @param fmt The serialization format to use. The format handles
+	 * low-level I/O.
+	 *
+	 * @return False if an error occured.
+	 */
+	bool WriteUntyped(zeek::detail::SerializationFormat* fmt) const;
+
 	/**
 	 * Returns true if the type can be represented by a Value. If
 	 * `atomic_only` is true, will not permit composite types. This
@@ -256,6 +281,10 @@ struct Value
 private:
 	friend class IPAddr;
 	Value(const Value& other) = delete;
+
+	// Reads or writes the value's data once its type is known.
+	bool ReadData(zeek::detail::SerializationFormat* fmt, bool untyped);
+	bool WriteData(zeek::detail::SerializationFormat* fmt, bool untyped) const;
 	};
 
 	} // namespace zeek::threading
@@ -0,0 +1,28 @@
+// See the file "COPYING" in the main distribution directory for copyright.
+//
+// Definitions shared by the snapshot log writer and input reader.
+
+#pragma once
+
+#include <cstdint>
+
+namespace zeek::threading::snapshot
+	{
+
+/**
+ * Snapshot files store rows of threading::Values in binary form so that
+ * they can be loaded again without any text parsing.
+ *
+ * A file starts with MAGIC, followed by a sequence of blocks. Each block
+ * consists of a 32-bit length in network byte order and that many bytes
+ * produced by BinarySerializationFormat. The first block holds the format
+ * VERSION, the number of fields, and the serialized threading::Fields.
+ * Every further block holds the serialized threading::Values of one row.
+ */
+inline constexpr char MAGIC[8] = {'#', 'z', 'e', 'e', 'k', 's', 'n', 'p'};
+inline constexpr uint32_t VERSION = 1;
+
+// File extension used unless configured otherwise.
+inline constexpr const char* DEFAULT_EXTENSION = "snapshot";
+
+	} // namespace zeek::threading::snapshot
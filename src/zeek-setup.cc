@@ -110,6 +110,8 @@ zeek::detail::Stmt* zeek::detail::stmts = nullptr;
 zeek::EventRegistry* zeek::event_registry = nullptr;
 zeek::detail::ProfileLogger* zeek::detail::profiling_logger = nullptr;
 zeek::detail::ProfileLogger* zeek::detail::segment_logger = nullptr;
+zeek::detail::PacketStageProfiler* zeek::detail::packet_stage_profiler = nullptr;
+zeek::detail::AnalyzerCostProfiler* zeek::detail::analyzer_cost_profiler = nullptr;
 zeek::detail::SampleLogger* zeek::detail::sample_logger = nullptr;
 
 zeek::detail::FragmentManager* zeek::detail::fragment_mgr = nullptr;
@@ -311,6 +313,9 @@ static void terminate_bro()
 		delete profiling_logger;
 		}
 
+	delete packet_stage_profiler;
+	packet_stage_profiler = nullptr;
+
 	event_mgr.Drain();
 
 	notifier::detail::registry.Terminate();
@@ -339,6 +344,8 @@ static void terminate_bro()
 	delete val_mgr;
 	delete session_mgr;
 	delete fragment_mgr;
+	// Deleted only now as the analyzers refer to it until destroyed.
+	delete analyzer_cost_profiler;
 	delete telemetry_mgr;
 
 	// free the global scope
@@ -859,6 +866,17 @@ SetupResult setup(int argc, char** argv, Options* zopts)
 				segment_logger = profiling_logger;
 			}
 
+		if ( packet_stage_sample_rate > 0 )
+			packet_stage_profiler = new PacketStageProfiler(packet_stage_sample_rate);
+
+		if ( analyzer_cost_sample_rate > 0 )
+			analyzer_cost_profiler = new AnalyzerCostProfiler(analyzer_cost_sample_rate);
+
+		// Calibrating takes a moment, which shouldn't fall into the
+		// processing of the first packet charged against a CPU budget.
+		if ( BifConst::AnalysisBudget::max_cpu_time > 0 )
+			profile_seconds_per_tick();
+
 		if ( ! run_state::reading_live && ! run_state::reading_traces )
 			// Set up network_time to track real-time, since
 			// we don't have any other source for it.